@@ -21,7 +21,11 @@
 #define AVLSET_HPP
 
 #include <functional>
+#include <string_view>
+#include <type_traits>
 #include "Set.hpp"
+#include "Stats.hpp"
+#include "StringLookup.hpp"
 
 template<typename ElementType>
 struct NodeA
@@ -34,7 +38,7 @@ struct NodeA
 
 
 template <typename ElementType>
-class AVLSet : public Set<ElementType>
+class AVLSet : public Set<ElementType>, public StringLookupFor<AVLSet<ElementType>, ElementType>
 {
 public:
     // A VisitFunction is a function that takes a reference to a const
@@ -78,6 +82,11 @@ public:
     // there are n elements in the AVL tree.
     bool contains(const ElementType& element) const override;
 
+    // An AVLSet of strings can also be searched for a std::string_view,
+    // which is compared with the elements in place.
+    template <typename Key, typename = std::enable_if_t<impl_::StringLookup__isKey<ElementType, Key>>>
+    bool contains(const Key& element) const;
+
 
     // size() returns the number of elements in the set.
     unsigned int size() const noexcept override;
@@ -112,6 +121,8 @@ private:
     bool balance;
     int sz;
     NodeA<ElementType>* root;
+    template <typename Key>
+    bool containsHelper(const Key& element) const;
     void deleteHelper(NodeA<ElementType>* node);
     void copyHelper(NodeA<ElementType>* node, NodeA<ElementType>* parent);
     int heightHelper(NodeA<ElementType>* node) const;
@@ -325,13 +336,31 @@ void AVLSet<ElementType>::add(const ElementType& element)
 
 template <typename ElementType>
 bool AVLSet<ElementType>::contains(const ElementType& element) const
+{
+    return containsHelper(element);
+}
+
+
+template <typename ElementType>
+template <typename Key, typename>
+bool AVLSet<ElementType>::contains(const Key& element) const
+{
+    return containsHelper(std::string_view{element});
+}
+
+
+template <typename ElementType>
+template <typename Key>
+bool AVLSet<ElementType>::containsHelper(const Key& element) const
 {
     NodeA<ElementType>* current = root;
+    unsigned int visited = 0;
     while(current != nullptr)
     {
+        visited++;
         if(current->element == element)
         {
-            return true;
+            break;
         }
         else if (current->element > element)
         {
@@ -342,7 +371,9 @@ bool AVLSet<ElementType>::contains(const ElementType& element) const
             current = current->right;
         } 
     }
-    return false;
+    SPELLCHECK_COUNT(avlSetContains, 1);
+    SPELLCHECK_COUNT(avlSetNodes, visited);
+    return current != nullptr;
 }
 
 
@@ -0,0 +1,167 @@
+// Alphabet.hpp
+//
+// An alphabet is the set of letters that WordChecker's suggestion
+// generators insert into, and substitute within, a misspelled word.  Each
+// is described by a policy: a struct whose "letters" member is a constexpr
+// string_view holding the letters in increasing order of their (unsigned)
+// byte values.  Because the letters are known at compile time, loops over
+// them (see forEachLetter()) are unrolled and specialized for each
+// alphabet, so supporting several alphabets costs nothing at run time
+// beyond choosing one per call.
+//
+// A policy's "utf8" member says how the words it's used with are encoded.
+// When it's true, words are UTF-8, the letters are code points (each
+// stored as the byte equal to its value, so only U+0000 through U+00FF are
+// possible), and WordChecker edits words containing anything beyond ASCII
+// one code point at a time.  When it's false, words are in a single-byte
+// encoding whose characters are the bytes themselves.
+//
+// The Alphabet enumeration names the policies, so that an alphabet can be
+// chosen when a WordChecker is constructed; withAlphabet() maps a value of
+// it back onto its policy.  A new alphabet is added by writing its policy,
+// giving it a value in the enumeration, and adding that to withAlphabet().
+
+#ifndef ALPHABET_HPP
+#define ALPHABET_HPP
+
+#include <cstddef>
+#include <string_view>
+#include <utility>
+
+
+
+// Uppercase ASCII letters, 'A' through 'Z', matching dictionaries stored in
+// uppercase (as in the original project).
+struct UppercaseAsciiLetters
+{
+    static constexpr std::string_view letters = "ABCDEFGHIJKLMNOPQRSTUVWXYZ";
+    static constexpr bool utf8 = true;
+};
+
+
+// Lowercase ASCII letters, 'a' through 'z'.
+struct LowercaseAsciiLetters
+{
+    static constexpr std::string_view letters = "abcdefghijklmnopqrstuvwxyz";
+    static constexpr bool utf8 = true;
+};
+
+
+// Both uppercase and lowercase ASCII letters, for dictionaries in which
+// case matters (e.g., proper nouns are capitalized).
+struct CaseInsensitiveAsciiLetters
+{
+    static constexpr std::string_view letters =
+        "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz";
+    static constexpr bool utf8 = true;
+};
+
+
+// The apostrophe, the ASCII letters, and the letters of ISO-8859-1 (Latin-1),
+// i.e., bytes 0xC0 through 0xFF other than the multiplication and division
+// signs (0xD7 and 0xF7), for dictionaries of Western European languages
+// stored in Latin-1.
+struct Latin1Letters
+{
+    static constexpr std::string_view letters =
+        "'"
+        "ABCDEFGHIJKLMNOPQRSTUVWXYZ"
+        "abcdefghijklmnopqrstuvwxyz"
+        "\xC0\xC1\xC2\xC3\xC4\xC5\xC6\xC7\xC8\xC9\xCA\xCB\xCC\xCD\xCE\xCF"
+        "\xD0\xD1\xD2\xD3\xD4\xD5\xD6\xD8\xD9\xDA\xDB\xDC\xDD\xDE\xDF"
+        "\xE0\xE1\xE2\xE3\xE4\xE5\xE6\xE7\xE8\xE9\xEA\xEB\xEC\xED\xEE\xEF"
+        "\xF0\xF1\xF2\xF3\xF4\xF5\xF6\xF8\xF9\xFA\xFB\xFC\xFD\xFE\xFF";
+    static constexpr bool utf8 = false;
+};
+
+
+// The same letters as Latin1Letters, as code points, for dictionaries of
+// Western European languages stored in UTF-8; each accented letter is
+// inserted or substituted as its two-byte UTF-8 encoding.
+struct Utf8Latin1Letters
+{
+    static constexpr std::string_view letters = Latin1Letters::letters;
+    static constexpr bool utf8 = true;
+};
+
+
+
+enum class Alphabet
+{
+    UppercaseAscii,
+    LowercaseAscii,
+    CaseInsensitiveAscii,
+    Latin1,
+    Utf8Latin1
+};
+
+
+
+// withAlphabet() calls the given function with a (default-constructed)
+// object of the policy type named by the given Alphabet value, returning
+// whatever it returns.
+template <typename Function>
+decltype(auto) withAlphabet(Alphabet alphabet, Function&& function)
+{
+    switch(alphabet)
+    {
+    case Alphabet::LowercaseAscii:
+        return function(LowercaseAsciiLetters{});
+    case Alphabet::CaseInsensitiveAscii:
+        return function(CaseInsensitiveAsciiLetters{});
+    case Alphabet::Latin1:
+        return function(Latin1Letters{});
+    case Alphabet::Utf8Latin1:
+        return function(Utf8Latin1Letters{});
+    default: // Alphabet::UppercaseAscii
+        return function(UppercaseAsciiLetters{});
+    }
+}
+
+
+// encodesUtf8() returns the "utf8" member of the policy named by the given
+// Alphabet value.
+inline bool encodesUtf8(Alphabet alphabet)
+{
+    return withAlphabet(alphabet, [](auto letters) { return decltype(letters)::utf8; });
+}
+
+
+// hasOnlyAsciiLetters() returns true if every letter of the given policy
+// is an ASCII character.
+template <typename Letters>
+constexpr bool hasOnlyAsciiLetters()
+{
+    for(char letter : Letters::letters)
+    {
+        if(static_cast<unsigned char>(letter) >= 0x80)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+
+
+namespace impl_
+{
+    template <typename Letters, typename Function, std::size_t... I>
+    void forEachLetter(Function& function, std::index_sequence<I...>)
+    {
+        (function(Letters::letters[I]), ...);
+    }
+}
+
+
+// forEachLetter() calls the given function with each letter of the given
+// policy, in order, as an unrolled sequence of calls.
+template <typename Letters, typename Function>
+void forEachLetter(Function&& function)
+{
+    impl_::forEachLetter<Letters>(function, std::make_index_sequence<Letters::letters.size()>{});
+}
+
+
+
+#endif // ALPHABET_HPP
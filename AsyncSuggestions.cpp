@@ -0,0 +1,69 @@
+// AsyncSuggestions.cpp
+
+#include "AsyncSuggestions.hpp"
+#include <utility>
+
+
+
+SuggestionsAwaitable::SuggestionsAwaitable(ThreadPool& executor, std::function<std::vector<std::string>()> work)
+    : executor{executor}, work{std::move(work)}
+{
+}
+
+
+bool SuggestionsAwaitable::await_ready() const noexcept
+{
+    return false;
+}
+
+
+void SuggestionsAwaitable::await_suspend(std::coroutine_handle<> waiting)
+{
+    executor.submit([this, waiting]()
+    {
+        try
+        {
+            result = work();
+        }
+        catch(...)
+        {
+            error = std::current_exception();
+        }
+        // Resuming may destroy this awaitable, so it's the last thing done.
+        waiting.resume();
+    });
+}
+
+
+std::vector<std::string> SuggestionsAwaitable::await_resume()
+{
+    if(error)
+    {
+        std::rethrow_exception(error);
+    }
+    return std::move(result);
+}
+
+
+SuggestionsAwaitable findSuggestionsAsync(
+    const WordChecker& checker, ThreadPool& executor, std::string word, CancellationToken token)
+{
+    return SuggestionsAwaitable{executor, [&checker, word = std::move(word), token = std::move(token)]()
+    {
+        token.throwIfCancelled();
+        return checker.findSuggestions(word, token);
+    }};
+}
+
+
+SuggestionsAwaitable findSuggestionsWithinAsync(
+    const WordChecker& checker, ThreadPool& executor, std::string word,
+    unsigned int maxDistance, SuggestionEngine engine, CancellationToken token)
+{
+    return SuggestionsAwaitable{executor, [&checker, word = std::move(word), maxDistance, engine,
+                                           token = std::move(token)]()
+    {
+        token.throwIfCancelled();
+        return checker.findSuggestionsWithin(word, maxDistance, engine, token);
+    }};
+}
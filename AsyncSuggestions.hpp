@@ -0,0 +1,71 @@
+// AsyncSuggestions.hpp
+//
+// findSuggestionsAsync() and findSuggestionsWithinAsync() let a C++20
+// coroutine, such as a request handler on an editor's event loop, ask a
+// WordChecker for suggestions without blocking its thread:
+//
+//     std::vector<std::string> suggestions =
+//         co_await findSuggestionsAsync(checker, pool, word, token);
+//
+// The suggestions are generated by a task on the given ThreadPool, which
+// serves as the executor, so no thread is started per request.  The
+// coroutine is resumed on the pool thread that ran the task, so one that
+// has to get back to its event loop's thread must hand itself back there
+// afterward.  Cancelling the token (e.g., because the user kept typing)
+// stops the task between small steps of its work, or before it starts,
+// and the co_await then throws an OperationCancelled.
+//
+// These are kept apart from WordChecker so that only code that uses them
+// needs C++20 coroutine support.
+
+#ifndef ASYNCSUGGESTIONS_HPP
+#define ASYNCSUGGESTIONS_HPP
+
+#include <coroutine>
+#include <exception>
+#include <functional>
+#include <string>
+#include <vector>
+#include "CancellationToken.hpp"
+#include "ThreadPool.hpp"
+#include "WordChecker.hpp"
+
+
+
+// A SuggestionsAwaitable is the result of findSuggestionsAsync(); its work
+// starts when it's awaited, which it must be only once.
+class SuggestionsAwaitable
+{
+public:
+    SuggestionsAwaitable(ThreadPool& executor, std::function<std::vector<std::string>()> work);
+
+    bool await_ready() const noexcept;
+    void await_suspend(std::coroutine_handle<> waiting);
+    std::vector<std::string> await_resume();
+
+private:
+    ThreadPool& executor;
+    std::function<std::vector<std::string>()> work;
+    std::vector<std::string> result;
+    std::exception_ptr error;
+};
+
+
+
+// findSuggestionsAsync() returns an awaitable whose result is
+// checker.findSuggestions(word).  The checker must outlive the co_await.
+SuggestionsAwaitable findSuggestionsAsync(
+    const WordChecker& checker, ThreadPool& executor, std::string word,
+    CancellationToken token = CancellationToken::none());
+
+
+// findSuggestionsWithinAsync() returns an awaitable whose result is
+// checker.findSuggestionsWithin(word, maxDistance, engine).
+SuggestionsAwaitable findSuggestionsWithinAsync(
+    const WordChecker& checker, ThreadPool& executor, std::string word,
+    unsigned int maxDistance, SuggestionEngine engine,
+    CancellationToken token = CancellationToken::none());
+
+
+
+#endif // ASYNCSUGGESTIONS_HPP
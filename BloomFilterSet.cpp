@@ -0,0 +1,181 @@
+// BloomFilterSet.cpp
+
+#include "BloomFilterSet.hpp"
+#include <functional>
+#include <stdexcept>
+#include <unordered_set>
+
+
+
+namespace
+{
+    std::uint64_t hashOf(std::string_view element) noexcept
+    {
+        // std::hash is remixed (with the finalizer from MurmurHash3) since
+        // its low and high bits aren't guaranteed to be well distributed.
+        // (It hashes a view the same as a string with the same characters.)
+        std::uint64_t h = std::hash<std::string_view>{}(element);
+        h ^= h >> 33;
+        h *= 0xff51afd7ed558ccdULL;
+        h ^= h >> 33;
+        h *= 0xc4ceb9fe1a85ec53ULL;
+        h ^= h >> 33;
+        return h;
+    }
+
+
+    // blockIndex() maps the high half of the hash onto [0, blockCount)
+    // without a division.
+    std::size_t blockIndex(std::uint64_t hash, std::size_t blockCount) noexcept
+    {
+        return static_cast<std::size_t>(((hash >> 32) * blockCount) >> 32);
+    }
+
+
+    // Each of the bits tested for a key is at a 9-bit offset into the
+    // 512-bit block, taken from successive values of a second hash derived
+    // from the low half of the first.
+    template <typename Visit>
+    void forEachBit(std::uint64_t hash, unsigned int bits, Visit visit) noexcept
+    {
+        std::uint32_t h = static_cast<std::uint32_t>(hash);
+        std::uint32_t step = static_cast<std::uint32_t>(hash >> 17) | 1;
+        for(unsigned int i = 0; i < bits; i++)
+        {
+            unsigned int offset = (h >> 23) & 511;
+            visit(offset >> 6, std::uint64_t{1} << (offset & 63));
+            h += step;
+            h *= 0x9e3779b1u;
+        }
+    }
+}
+
+
+BloomFilterSet::BloomFilterSet(Set<std::string>& backing, std::size_t expectedElements,
+                               unsigned int bitsPerElement)
+    : backing{backing}, backingLookup{dynamic_cast<const StringLookup*>(&backing)},
+      blocks{nullptr}, blockCount{0}, filteredSize{0}
+{
+    if(backing.size() != 0)
+    {
+        throw std::invalid_argument{"a BloomFilterSet's backing Set must be empty unless given its words"};
+    }
+    std::size_t bits = expectedElements * (bitsPerElement == 0 ? 1 : bitsPerElement);
+    blockCount = bits / 512 + 1;
+    blocks.reset(new Block[blockCount]{});
+}
+
+
+BloomFilterSet::BloomFilterSet(Set<std::string>& backing, const std::vector<std::string>& words,
+                               unsigned int bitsPerElement)
+    : backing{backing}, backingLookup{dynamic_cast<const StringLookup*>(&backing)},
+      blocks{nullptr}, blockCount{0}, filteredSize{0}
+{
+    std::size_t bits = words.size() * (bitsPerElement == 0 ? 1 : bitsPerElement);
+    blockCount = bits / 512 + 1;
+    blocks.reset(new Block[blockCount]{});
+
+    // The backing Set holds nothing but these words when, once they're all
+    // in it, it's the same size as the list without its duplicates.
+    std::unordered_set<std::string_view> distinct;
+    distinct.reserve(words.size());
+    for(const std::string& word : words)
+    {
+        if(!backing.contains(word))
+        {
+            backing.add(word);
+        }
+        addToFilter(word);
+        distinct.insert(word);
+    }
+    if(backing.size() != distinct.size())
+    {
+        throw std::invalid_argument{"a BloomFilterSet's backing Set holds words it wasn't given"};
+    }
+    filteredSize = backing.size();
+}
+
+
+bool BloomFilterSet::isImplemented() const noexcept
+{
+    return true;
+}
+
+
+void BloomFilterSet::add(const std::string& element)
+{
+    bool wasCurrent = isCurrent();
+    backing.add(element);
+    addToFilter(element);
+
+    if(wasCurrent)
+    {
+        filteredSize = backing.size();
+    }
+}
+
+
+bool BloomFilterSet::contains(const std::string& element) const
+{
+    if(isCurrent() && !mightContain(element))
+    {
+        return false;
+    }
+    return backing.contains(element);
+}
+
+
+bool BloomFilterSet::containsView(std::string_view element) const
+{
+    if(isCurrent() && !mightContain(element))
+    {
+        return false;
+    }
+    if(backingLookup != nullptr)
+    {
+        return backingLookup->containsView(element);
+    }
+    return backing.contains(std::string{element});
+}
+
+
+unsigned int BloomFilterSet::size() const noexcept
+{
+    return backing.size();
+}
+
+
+bool BloomFilterSet::mightContain(std::string_view element) const noexcept
+{
+    std::uint64_t hash = hashOf(element);
+    const Block& block = blocks[blockIndex(hash, blockCount)];
+    bool found = true;
+    forEachBit(hash, BITS_PER_KEY, [&block, &found](unsigned int word, std::uint64_t mask)
+    {
+        found &= (block.words[word] & mask) != 0;
+    });
+    return found;
+}
+
+
+std::size_t BloomFilterSet::memoryUsage() const noexcept
+{
+    return blockCount * sizeof(Block);
+}
+
+
+void BloomFilterSet::addToFilter(std::string_view element) noexcept
+{
+    std::uint64_t hash = hashOf(element);
+    Block& block = blocks[blockIndex(hash, blockCount)];
+    forEachBit(hash, BITS_PER_KEY, [&block](unsigned int word, std::uint64_t mask)
+    {
+        block.words[word] |= mask;
+    });
+}
+
+
+bool BloomFilterSet::isCurrent() const noexcept
+{
+    return filteredSize == backing.size();
+}
@@ -0,0 +1,131 @@
+// BloomFilterSet.hpp
+//
+// A BloomFilterSet is a Set of strings that sits in front of another Set
+// (the "backing" Set), answering most lookups of strings that aren't in
+// the set without touching the backing Set at all.  That pays off in
+// WordChecker, where nearly every candidate that a suggestion generator
+// probes is not a word, and a miss in a HashSet, AVLSet or SkipListSet
+// costs a hash and a chain walk or a full root-to-leaf descent.
+//
+// The filter is a blocked Bloom filter: an array of 64-byte blocks, each
+// the size of a cache line.  A string's hash selects one block and sets
+// (or, for a lookup, tests) several bits within it, so a lookup touches
+// exactly one cache line.  A lookup the filter rejects is certainly not in
+// the set; one it accepts is passed on to the backing Set, which gives the
+// final answer, so the filter never changes any result.  The proportion of
+// non-members that it fails to reject (the false positive rate) is about 1%
+// at the default of 10 bits per element, and rises if more elements are
+// added than the filter was sized for.
+//
+// A BloomFilterSet can be searched for a std::string_view, which it hashes
+// in place and, if the filter accepts it, passes on to the backing Set as a
+// view if the backing Set is a StringLookup, or copied into a string if not.
+//
+// The filter has to see every word in the backing Set.  A BloomFilterSet
+// is either put in front of an empty Set, or given the list of the words
+// (the dictionary) to build its filter from, which are added to the
+// backing Set if it doesn't already hold them; since a Set can't be
+// iterated, a non-empty backing Set without such a list is rejected with
+// a std::invalid_argument.  Afterward, words must be added through the
+// BloomFilterSet.  If the backing Set ever holds a different number of
+// elements than the filter has seen (because words were added to it
+// directly), the filter is bypassed and every lookup goes to the backing
+// Set.
+
+#ifndef BLOOMFILTERSET_HPP
+#define BLOOMFILTERSET_HPP
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+#include "Set.hpp"
+#include "StringLookup.hpp"
+
+
+
+class BloomFilterSet : public Set<std::string>, public StringLookup
+{
+public:
+    // The number of bits set and tested in a block per element.
+    static constexpr unsigned int BITS_PER_KEY = 8;
+
+public:
+    // Initializes a BloomFilterSet in front of the given backing Set, which
+    // must be empty, with a filter sized for the given number of elements
+    // at the given number of bits per element.  The backing Set must
+    // outlive the BloomFilterSet.  Throws a std::invalid_argument if the
+    // backing Set isn't empty.
+    BloomFilterSet(Set<std::string>& backing, std::size_t expectedElements,
+                   unsigned int bitsPerElement = 10);
+
+    // Initializes a BloomFilterSet in front of the given backing Set, with
+    // a filter sized for and built from the given words, adding those that
+    // the backing Set doesn't already hold to it.  Throws a
+    // std::invalid_argument if the backing Set then holds words that
+    // aren't among them.
+    BloomFilterSet(Set<std::string>& backing, const std::vector<std::string>& words,
+                   unsigned int bitsPerElement = 10);
+
+    BloomFilterSet(const BloomFilterSet& s) = delete;
+    BloomFilterSet& operator=(const BloomFilterSet& s) = delete;
+
+
+    bool isImplemented() const noexcept override;
+
+
+    // add() adds an element to both the filter and the backing Set.
+    void add(const std::string& element) override;
+
+
+    // contains() returns false right away if the filter rejects the given
+    // element, otherwise it returns whether the backing Set contains it.
+    bool contains(const std::string& element) const override;
+
+    template <typename Key, typename = std::enable_if_t<impl_::StringLookup__isKey<std::string, Key>>>
+    bool contains(const Key& element) const
+    {
+        return containsView(element);
+    }
+
+    bool containsView(std::string_view element) const override;
+
+
+    // size() returns the number of elements in the backing Set.
+    unsigned int size() const noexcept override;
+
+
+    // mightContain() returns false if the filter rejects the given element,
+    // true otherwise, without consulting the backing Set.  Comparing it to
+    // contains() on strings known not to be in the set measures the false
+    // positive rate.
+    bool mightContain(std::string_view element) const noexcept;
+
+
+    // memoryUsage() returns the size of the filter, in bytes.
+    std::size_t memoryUsage() const noexcept;
+
+
+private:
+    struct alignas(64) Block
+    {
+        std::uint64_t words[8];
+    };
+
+    Set<std::string>& backing;
+    const StringLookup* backingLookup;
+    std::unique_ptr<Block[]> blocks;
+    std::size_t blockCount;
+    unsigned int filteredSize;
+
+    // addToFilter() sets the given element's bits in the filter.
+    void addToFilter(std::string_view element) noexcept;
+
+    bool isCurrent() const noexcept;
+};
+
+
+
+#endif // BLOOMFILTERSET_HPP
@@ -0,0 +1,85 @@
+// CancellationToken.hpp
+//
+// A CancellationToken lets one thread ask work running on another to stop
+// early; e.g., an editor cancels the suggestions it requested for a word
+// when the user keeps typing.  Copies of a token share its state, so the
+// requester keeps one copy and hands another to the work, which checks
+// cancelled() now and then and, once it's true, gives up by throwing an
+// OperationCancelled.
+
+#ifndef CANCELLATIONTOKEN_HPP
+#define CANCELLATIONTOKEN_HPP
+
+#include <atomic>
+#include <memory>
+#include <stdexcept>
+
+
+
+class OperationCancelled : public std::runtime_error
+{
+public:
+    OperationCancelled()
+        : std::runtime_error{"operation cancelled"}
+    {
+    }
+};
+
+
+
+class CancellationToken
+{
+public:
+    // Initializes a token that hasn't been cancelled yet.
+    CancellationToken()
+        : state{std::make_shared<std::atomic<bool>>(false)}
+    {
+    }
+
+
+    // none() returns a token that can never be cancelled, for calls that
+    // need a token but have nobody to cancel them.
+    static CancellationToken none() noexcept
+    {
+        return CancellationToken{nullptr};
+    }
+
+
+    // cancel() cancels this token and every copy of it.
+    void cancel() noexcept
+    {
+        if(state)
+        {
+            state->store(true, std::memory_order_relaxed);
+        }
+    }
+
+
+    bool cancelled() const noexcept
+    {
+        return state && state->load(std::memory_order_relaxed);
+    }
+
+
+    // throwIfCancelled() throws an OperationCancelled if the token has
+    // been cancelled.
+    void throwIfCancelled() const
+    {
+        if(cancelled())
+        {
+            throw OperationCancelled{};
+        }
+    }
+
+
+private:
+    std::shared_ptr<std::atomic<bool>> state;
+
+    explicit CancellationToken(std::nullptr_t) noexcept
+    {
+    }
+};
+
+
+
+#endif // CANCELLATIONTOKEN_HPP
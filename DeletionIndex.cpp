@@ -0,0 +1,235 @@
+// DeletionIndex.cpp
+
+#include "DeletionIndex.hpp"
+#include <algorithm>
+#include <functional>
+#include <utility>
+
+
+
+namespace
+{
+    // Verifying a candidate takes a fraction of a microsecond, so the
+    // cancellation token is only checked between runs of this many.
+    constexpr std::size_t CANCELLATION_INTERVAL = 256;
+
+
+    std::uint64_t hashOf(std::string_view word)
+    {
+        return std::hash<std::string_view>{}(word);
+    }
+
+
+    // collectVariants() hashes the buffer, then each variant made by deleting
+    // up to "deletions" more of its characters at positions from "start" on.
+    // Deleting in increasing order of position visits each set of deleted
+    // positions once; repeated letters can still produce equal variants, so
+    // the caller removes duplicates afterward.
+    void collectVariants(std::string& buffer, std::size_t start, unsigned int deletions,
+                         std::vector<std::uint64_t>& hashes)
+    {
+        hashes.push_back(hashOf(buffer));
+        if(deletions == 0)
+        {
+            return;
+        }
+        for(std::size_t i = start; i < buffer.length(); i++)
+        {
+            char deleted = buffer[i];
+            buffer.erase(i, 1);
+            collectVariants(buffer, i, deletions - 1, hashes);
+            buffer.insert(i, 1, deleted);
+        }
+    }
+
+
+    // editDistance() returns the optimal string alignment distance between
+    // two words (insertions, deletions, replacements and swaps of adjacent
+    // characters each costing 1), or limit + 1 if it's larger than limit.
+    unsigned int editDistance(std::string_view a, std::string_view b, unsigned int limit)
+    {
+        std::size_t n = a.length();
+        std::size_t m = b.length();
+        if((n > m ? n - m : m - n) > limit)
+        {
+            return limit + 1;
+        }
+
+        std::vector<unsigned int> previous2(m + 1);
+        std::vector<unsigned int> previous(m + 1);
+        std::vector<unsigned int> current(m + 1);
+        for(std::size_t j = 0; j <= m; j++)
+        {
+            previous[j] = j;
+        }
+        for(std::size_t i = 1; i <= n; i++)
+        {
+            current[0] = i;
+            unsigned int rowMinimum = current[0];
+            for(std::size_t j = 1; j <= m; j++)
+            {
+                unsigned int cost = a[i - 1] == b[j - 1] ? 0 : 1;
+                current[j] = std::min({previous[j] + 1, current[j - 1] + 1, previous[j - 1] + cost});
+                if(i > 1 && j > 1 && a[i - 1] == b[j - 2] && a[i - 2] == b[j - 1])
+                {
+                    current[j] = std::min(current[j], previous2[j - 2] + 1);
+                }
+                rowMinimum = std::min(rowMinimum, current[j]);
+            }
+            if(rowMinimum > limit)
+            {
+                return limit + 1;
+            }
+            std::swap(previous2, previous);
+            std::swap(previous, current);
+        }
+        return std::min(previous[m], limit + 1);
+    }
+}
+
+
+DeletionIndex::DeletionIndex(unsigned int maxDistance)
+    : distance{std::clamp(maxDistance, 1u, MAX_DISTANCE)}
+{
+}
+
+
+bool DeletionIndex::isImplemented() const noexcept
+{
+    return true;
+}
+
+
+void DeletionIndex::add(const std::string& element)
+{
+    if(contains(element))
+    {
+        return;
+    }
+
+    unsigned int id = words.size();
+    words.push_back(element);
+    ids.emplace(hashOf(element), id);
+
+    std::vector<std::uint64_t> hashes;
+    deletionVariants(element, distance, hashes);
+    for(std::uint64_t hash : hashes)
+    {
+        variants[hash].push_back(id);
+    }
+}
+
+
+bool DeletionIndex::contains(const std::string& element) const
+{
+    auto [first, last] = ids.equal_range(hashOf(element));
+    for(auto i = first; i != last; ++i)
+    {
+        if(words[i->second] == element)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+
+unsigned int DeletionIndex::size() const noexcept
+{
+    return words.size();
+}
+
+
+unsigned int DeletionIndex::maxDistance() const noexcept
+{
+    return distance;
+}
+
+
+std::vector<std::string> DeletionIndex::findSuggestions(const std::string& word, unsigned int distance) const
+{
+    return findSuggestions(word, distance, CancellationToken::none());
+}
+
+
+std::vector<std::string> DeletionIndex::findSuggestions(
+    const std::string& word, unsigned int distance, const CancellationToken& token) const
+{
+    distance = std::min(distance, this->distance);
+
+    std::vector<std::uint64_t> hashes;
+    deletionVariants(word, distance, hashes);
+    token.throwIfCancelled();
+
+    std::vector<unsigned int> candidates;
+    for(std::uint64_t hash : hashes)
+    {
+        auto found = variants.find(hash);
+        if(found != variants.end())
+        {
+            candidates.insert(candidates.end(), found->second.begin(), found->second.end());
+        }
+    }
+    std::sort(candidates.begin(), candidates.end());
+    candidates.erase(std::unique(candidates.begin(), candidates.end()), candidates.end());
+
+    std::vector<std::pair<unsigned int, const std::string*>> verified;
+    for(std::size_t c = 0; c < candidates.size(); c++)
+    {
+        if(c % CANCELLATION_INTERVAL == 0)
+        {
+            token.throwIfCancelled();
+        }
+        unsigned int id = candidates[c];
+        unsigned int d = editDistance(word, words[id], distance);
+        if(d <= distance)
+        {
+            verified.emplace_back(d, &words[id]);
+        }
+    }
+    std::sort(verified.begin(), verified.end(),
+        [](const auto& a, const auto& b)
+        {
+            return a.first != b.first ? a.first < b.first : *a.second < *b.second;
+        });
+
+    std::vector<std::string> result;
+    result.reserve(verified.size());
+    for(const auto& v : verified)
+    {
+        result.push_back(*v.second);
+    }
+    return result;
+}
+
+
+std::size_t DeletionIndex::memoryUsage() const noexcept
+{
+    // Each hash table node holds a key, a vector and a link, and is counted
+    // as such; allocator overhead isn't included.
+    std::size_t bytes = sizeof(*this) + words.capacity() * sizeof(std::string);
+    for(const std::string& word : words)
+    {
+        if(word.capacity() > std::string{}.capacity())
+        {
+            bytes += word.capacity() + 1;
+        }
+    }
+    bytes += ids.bucket_count() * sizeof(void*) + ids.size() * (sizeof(void*) + sizeof(*ids.begin()));
+    bytes += variants.bucket_count() * sizeof(void*);
+    for(const auto& variant : variants)
+    {
+        bytes += sizeof(void*) + sizeof(variant) + variant.second.capacity() * sizeof(unsigned int);
+    }
+    return bytes;
+}
+
+
+void DeletionIndex::deletionVariants(std::string_view word, unsigned int deletions,
+                                     std::vector<std::uint64_t>& hashes)
+{
+    std::string buffer{word};
+    collectVariants(buffer, 0, deletions, hashes);
+    std::sort(hashes.begin(), hashes.end());
+    hashes.erase(std::unique(hashes.begin(), hashes.end()), hashes.end());
+}
@@ -0,0 +1,102 @@
+// DeletionIndex.hpp
+//
+// A DeletionIndex is an implementation of a Set of strings that also
+// indexes, for every word added to it, each variant of the word that can be
+// made by deleting up to a fixed number of its characters (the "symmetric
+// delete" approach).  Two words are within edit distance d of one another
+// only if deleting at most d characters from each of them can make them
+// equal, so the suggestions for a misspelled word can be found by looking
+// up the misspelling's own deletion variants in the index, then verifying
+// the (few) words found there, rather than by probing the dictionary with
+// every possible edit of the misspelling.  This makes edit distance 2
+// affordable, at the cost of memory: a word of length n has on the order
+// of n^d deletion variants.
+//
+// To keep that memory down, variants are indexed by a 64-bit hash rather
+// than stored as strings; a hash collision can only add a candidate, which
+// the verification step then rejects.
+//
+// A word is its own variant with nothing deleted, but its variant list
+// also holds every word that deletes to it, which for a short word at
+// distance 2 can be thousands; so contains() instead looks the word up in
+// a separate table from each word's hash to its id.
+
+#ifndef DELETIONINDEX_HPP
+#define DELETIONINDEX_HPP
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+#include "CancellationToken.hpp"
+#include "Set.hpp"
+
+
+
+class DeletionIndex : public Set<std::string>
+{
+public:
+    // The largest maximum distance that an index can be built for.
+    static constexpr unsigned int MAX_DISTANCE = 2;
+
+public:
+    // Initializes an empty DeletionIndex that can find suggestions up to
+    // the given edit distance (which is clamped to 1..MAX_DISTANCE).
+    explicit DeletionIndex(unsigned int maxDistance = 2);
+
+
+    bool isImplemented() const noexcept override;
+
+
+    // add() adds a word to the set and indexes its deletion variants.  If
+    // the word is already in the set, this function has no effect.
+    void add(const std::string& element) override;
+
+
+    // contains() returns true if the given word is in the set, false
+    // otherwise.
+    bool contains(const std::string& element) const override;
+
+
+    // size() returns the number of words in the set.
+    unsigned int size() const noexcept override;
+
+
+    // maxDistance() returns the largest edit distance the index was built
+    // to find suggestions within.
+    unsigned int maxDistance() const noexcept;
+
+
+    // findSuggestions() returns the words within the given edit distance
+    // (at most maxDistance()) of the given word, counting insertions,
+    // deletions, replacements and swaps of adjacent characters as one edit
+    // each.  The suggestions are ordered by distance, then alphabetically.
+    // Given a CancellationToken, it throws an OperationCancelled if the
+    // token is cancelled before it's done.
+    std::vector<std::string> findSuggestions(const std::string& word, unsigned int distance) const;
+    std::vector<std::string> findSuggestions(
+        const std::string& word, unsigned int distance, const CancellationToken& token) const;
+
+
+    // memoryUsage() returns an estimate, in bytes, of the memory used by
+    // the index, so that its cost can be weighed against its speed.
+    std::size_t memoryUsage() const noexcept;
+
+
+private:
+    unsigned int distance;
+    std::vector<std::string> words;
+    std::unordered_map<std::uint64_t, std::vector<unsigned int>> variants;
+    std::unordered_multimap<std::uint64_t, unsigned int> ids;
+
+    // deletionVariants() appends to "hashes" the hashes of the word and of
+    // every variant made by deleting up to "deletions" of its characters,
+    // each hash appearing once.
+    static void deletionVariants(std::string_view word, unsigned int deletions,
+                                 std::vector<std::uint64_t>& hashes);
+};
+
+
+
+#endif // DELETIONINDEX_HPP
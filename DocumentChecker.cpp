@@ -0,0 +1,183 @@
+// DocumentChecker.cpp
+
+#include "DocumentChecker.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <system_error>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+
+
+namespace
+{
+    [[noreturn]] void throwSystemError(const std::string& what)
+    {
+        throw std::system_error{errno, std::generic_category(), what};
+    }
+
+
+    // A FileDescriptor closes the file it owns when it dies.
+    struct FileDescriptor
+    {
+        int fd;
+
+        ~FileDescriptor() noexcept
+        {
+            if(fd >= 0)
+            {
+                close(fd);
+            }
+        }
+    };
+
+
+    // A Mapping unmaps the region it owns when it dies.
+    struct Mapping
+    {
+        void* address;
+        std::size_t length;
+
+        ~Mapping() noexcept
+        {
+            if(address != MAP_FAILED)
+            {
+                munmap(address, length);
+            }
+        }
+    };
+}
+
+
+DocumentChecker::DocumentChecker(const WordChecker& checker)
+    : checker{checker}, upper(CHUNK_SIZE), wordsChecked{0}, counted{0}, line{1}, lineStart{0}
+{
+}
+
+
+std::uint64_t DocumentChecker::checkText(std::string_view text, MisspellingFunction found)
+{
+    reset();
+    scan(text.data(), text.data() + text.length(), true, 0, found);
+    return wordsChecked;
+}
+
+
+std::uint64_t DocumentChecker::checkFile(const std::string& path, MisspellingFunction found,
+                                         std::size_t windowSize)
+{
+    reset();
+
+    FileDescriptor file{open(path.c_str(), O_RDONLY)};
+    if(file.fd < 0)
+    {
+        throwSystemError("cannot open " + path);
+    }
+    struct stat status;
+    if(fstat(file.fd, &status) != 0)
+    {
+        throwSystemError("cannot stat " + path);
+    }
+    std::uint64_t size = status.st_size;
+
+    // Windows start on page boundaries, as mmap() requires, and are at least
+    // two pages long, so that each one gets past the page it starts in.
+    std::size_t pageSize = sysconf(_SC_PAGESIZE);
+    windowSize = std::max(windowSize - windowSize % pageSize, 2 * pageSize);
+
+    std::uint64_t position = 0;
+    while(position < size)
+    {
+        std::uint64_t mapStart = position - position % pageSize;
+        std::size_t mapLength = std::min<std::uint64_t>(windowSize, size - mapStart);
+        Mapping window{mmap(nullptr, mapLength, PROT_READ, MAP_PRIVATE, file.fd, mapStart), mapLength};
+        if(window.address == MAP_FAILED)
+        {
+            throwSystemError("cannot map " + path);
+        }
+        madvise(window.address, mapLength, MADV_SEQUENTIAL);
+
+        const char* base = static_cast<const char*>(window.address);
+        bool atEnd = mapStart + mapLength == size;
+        position += scan(base + (position - mapStart), base + mapLength, atEnd, position, found);
+    }
+    return wordsChecked;
+}
+
+
+std::size_t DocumentChecker::scan(const char* begin, const char* end, bool atEnd, std::uint64_t offset,
+                                  MisspellingFunction& found)
+{
+    const char* chunk = begin;
+    while(chunk != end)
+    {
+        std::size_t length = std::min<std::size_t>(CHUNK_SIZE, end - chunk);
+        bool lastChunk = chunk + length == end;
+        tokens.clear();
+        tokenizer.tokenize(chunk, length, upper.data(), tokens);
+
+        // A word running up to the end of the chunk may continue past it, so
+        // it's left for the next chunk (or window) to start with, unless it
+        // fills a whole chunk (or all that's left to scan), in which case
+        // it's checked as it is; a word longer than a chunk is checked
+        // CHUNK_SIZE bytes at a time.
+        std::size_t consumed = length;
+        for(const Tokenizer::Token& token : tokens)
+        {
+            bool fillsChunk = token.offset == 0 && (length == CHUNK_SIZE || chunk == begin);
+            if(token.offset + token.length == length && !fillsChunk && !(lastChunk && atEnd))
+            {
+                consumed = token.offset;
+                break;
+            }
+
+            word.assign(upper.data() + token.offset, token.length);
+            wordsChecked++;
+            if(!checker.wordExists(word))
+            {
+                std::uint64_t wordOffset = offset + (chunk - begin) + token.offset;
+                countLines(begin, offset, wordOffset);
+                found(Misspelling{wordOffset, line, wordOffset - lineStart + 1, word});
+            }
+        }
+
+        chunk += consumed;
+        if(consumed < length && lastChunk)
+        {
+            break;
+        }
+    }
+    countLines(begin, offset, offset + (chunk - begin));
+    return chunk - begin;
+}
+
+
+void DocumentChecker::countLines(const char* begin, std::uint64_t baseOffset, std::uint64_t offset) noexcept
+{
+    const char* p = begin + (counted - baseOffset);
+    const char* end = begin + (offset - baseOffset);
+    while(p < end)
+    {
+        const void* newline = std::memchr(p, '\n', end - p);
+        if(newline == nullptr)
+        {
+            break;
+        }
+        p = static_cast<const char*>(newline) + 1;
+        line++;
+        lineStart = baseOffset + (p - begin);
+    }
+    counted = offset;
+}
+
+
+void DocumentChecker::reset() noexcept
+{
+    wordsChecked = 0;
+    counted = 0;
+    line = 1;
+    lineStart = 0;
+}
@@ -0,0 +1,113 @@
+// DocumentChecker.hpp
+//
+// A DocumentChecker finds the misspelled words in a text, using a
+// WordChecker to look each one up.  A word is a run of ASCII letters;
+// everything else (digits, punctuation, whitespace, other bytes) separates
+// words.  Words are uppercased before they're looked up, since that's the
+// form in which dictionary words are stored.
+//
+// Words are found without regard to the WordChecker's alphabet, so a
+// letter outside ASCII (such as the bytes of an accented letter in UTF-8)
+// splits the word it's in, and the pieces are looked up separately; a
+// DocumentChecker is only meant for ASCII words.  A word longer than
+// CHUNK_SIZE bytes is looked up CHUNK_SIZE bytes at a time.
+//
+// Files are checked through a memory-mapped window that slides along the
+// file, so that the memory used stays the same no matter how large the
+// file is.  Each window is split into words, and uppercased, a chunk at a
+// time by a Tokenizer, into buffers that are reused from chunk to chunk
+// rather than copying each word into a string of its own.  Lines are only
+// counted (with memchr()) as far as the words that need reporting.
+
+#ifndef DOCUMENTCHECKER_HPP
+#define DOCUMENTCHECKER_HPP
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "Tokenizer.hpp"
+#include "WordChecker.hpp"
+
+
+
+class DocumentChecker
+{
+public:
+    // A Misspelling describes one misspelled word: its byte offset from the
+    // start of the text, the line and column (both counted from 1, with
+    // columns counted in bytes) at which it starts, and the word itself,
+    // uppercased.  The word is only valid until the MisspellingFunction
+    // that receives it returns.
+    struct Misspelling
+    {
+        std::uint64_t offset;
+        std::uint64_t line;
+        std::uint64_t column;
+        std::string_view word;
+    };
+
+    // A MisspellingFunction is called once for each misspelled word, in
+    // the order in which they appear.
+    using MisspellingFunction = std::function<void(const Misspelling&)>;
+
+    // The default size of the window through which files are mapped.
+    static constexpr std::size_t DEFAULT_WINDOW_SIZE = std::size_t{64} << 20;
+
+    // The number of bytes tokenized at a time.
+    static constexpr std::size_t CHUNK_SIZE = std::size_t{64} << 10;
+
+public:
+    // Initializes a DocumentChecker that checks words using the given
+    // WordChecker, which must outlive it.
+    explicit DocumentChecker(const WordChecker& checker);
+
+
+    // checkText() checks the given text, calling "found" for each
+    // misspelled word, and returns the number of words checked.
+    std::uint64_t checkText(std::string_view text, MisspellingFunction found);
+
+
+    // checkFile() checks the file with the given path, mapping it into
+    // memory windowSize bytes at a time, calling "found" for each
+    // misspelled word, and returns the number of words checked.  It throws
+    // a std::system_error if the file can't be opened or mapped.
+    std::uint64_t checkFile(const std::string& path, MisspellingFunction found,
+                            std::size_t windowSize = DEFAULT_WINDOW_SIZE);
+
+
+private:
+    const WordChecker& checker;
+    Tokenizer tokenizer;
+    std::vector<char> upper;
+    std::vector<Tokenizer::Token> tokens;
+    std::string word;
+    std::uint64_t wordsChecked;
+
+    // Lines have been counted through the byte at offset "counted"; the
+    // line containing that point is numbered "line" and starts at offset
+    // "lineStart".
+    std::uint64_t counted;
+    std::uint64_t line;
+    std::uint64_t lineStart;
+
+    // scan() checks the words in [begin, end), whose first byte is at the
+    // given offset in the text, and returns the number of bytes consumed.
+    // Unless atEnd is true, a word running up to "end" might continue past
+    // it, so scanning stops just before that word (unless it fills a whole
+    // chunk, in which case it's checked as it is).
+    std::size_t scan(const char* begin, const char* end, bool atEnd, std::uint64_t offset,
+                     MisspellingFunction& found);
+
+    // countLines() counts the lines in the text up to the given offset,
+    // where "begin" is the byte at the given base offset and the bytes from
+    // "counted" through the given offset are all in memory.
+    void countLines(const char* begin, std::uint64_t baseOffset, std::uint64_t offset) noexcept;
+
+    void reset() noexcept;
+};
+
+
+
+#endif // DOCUMENTCHECKER_HPP
@@ -0,0 +1,490 @@
+// FlatHashSet.hpp
+//
+// A FlatHashSet is an implementation of a Set that is an open-addressed
+// hash table in the style of Abseil's "Swiss tables".  The elements are
+// stored directly in one array of slots, alongside an array of control
+// bytes, one per slot, each either EMPTY or holding the low 7 bits of its
+// element's hash (the element's fingerprint).
+//
+// A lookup starts at the slot chosen by the rest of the hash and compares
+// the fingerprint with 16 control bytes at once (a few SSE2 instructions,
+// or a loop where SSE2 isn't available), comparing elements only in the
+// slots whose fingerprints match; an empty slot among the 16 ends the
+// search, and otherwise it goes on to another group of 16.  So a miss
+// usually costs one load of control bytes and no element comparisons at
+// all, where a HashSet has to follow the pointer to a chain and another
+// pointer per node of it.
+//
+// The capacity is a power of two, at least 16, and is doubled whenever
+// the table would otherwise be more than 7/8 full.  Since elements are
+// never removed from a Set, no slot ever needs to be marked as deleted.
+
+#ifndef FLATHASHSET_HPP
+#define FLATHASHSET_HPP
+
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <new>
+#include <utility>
+#include "Set.hpp"
+#include "Stats.hpp"
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+
+
+template <typename ElementType>
+class FlatHashSet : public Set<ElementType>
+{
+public:
+    // The capacity of the FlatHashSet before anything has been added to it.
+    static constexpr unsigned int DEFAULT_CAPACITY = 16;
+
+    // A HashFunction is a function that takes a reference to a const
+    // ElementType and returns an unsigned int.
+    using HashFunction = std::function<unsigned int(const ElementType&)>;
+
+public:
+    // Initializes a FlatHashSet to be empty, so that it will use the given
+    // hash function whenever it needs to hash an element.  Since each hash
+    // provides both a starting slot and a fingerprint, all of its bits
+    // should be well mixed.
+    explicit FlatHashSet(HashFunction hashFunction);
+
+    // Cleans up the FlatHashSet so that it leaks no memory.
+    ~FlatHashSet() noexcept override;
+
+    // Initializes a new FlatHashSet to be a copy of an existing one.
+    FlatHashSet(const FlatHashSet& s);
+
+    // Initializes a new FlatHashSet whose contents are moved from an
+    // expiring one, which is left empty, without a table until something
+    // is added to it.  The hash function is copied rather than moved, so
+    // that the expiring one can still be used (which is why this might
+    // throw).
+    FlatHashSet(FlatHashSet&& s);
+
+    // Assigns an existing FlatHashSet into another.
+    FlatHashSet& operator=(const FlatHashSet& s);
+
+    // Assigns an expiring FlatHashSet into another, by swapping their
+    // contents.
+    FlatHashSet& operator=(FlatHashSet&& s) noexcept;
+
+
+    bool isImplemented() const noexcept override;
+
+
+    // add() adds an element to the set.  If the element is already in the
+    // set, this function has no effect.  Growing the table, when needed,
+    // moves the elements into the new one and takes linear time; otherwise,
+    // and amortized, add() runs in constant time (assuming a good hash
+    // function).
+    void add(const ElementType& element) override;
+
+
+    // contains() returns true if the given element is already in the set,
+    // false otherwise.  This function runs in constant time (assuming a
+    // good hash function).
+    bool contains(const ElementType& element) const override;
+
+
+    // size() returns the number of elements in the set.
+    unsigned int size() const noexcept override;
+
+
+    // capacity() returns the number of slots in the table.
+    unsigned int capacity() const noexcept;
+
+
+private:
+    static constexpr unsigned int GROUP_WIDTH = 16;
+    static constexpr signed char EMPTY = -128;
+
+    HashFunction hashFunction;
+
+    // There are cp + GROUP_WIDTH - 1 control bytes; the last ones mirror
+    // the first, so that a group starting near the end of the table can
+    // be loaded in one piece.
+    signed char* control;
+    ElementType* slots;
+    unsigned int sz;
+    unsigned int cp;
+
+    // allocate() makes an empty table with the given capacity, the old
+    // one having been released (or never allocated).
+    void allocate(unsigned int capacity);
+
+    // release() destroys the elements and frees the table.
+    void release() noexcept;
+
+    // find() returns true if the element is in the table, setting "slot" to
+    // its slot, or returns false, setting "slot" to the empty slot in which
+    // it belongs.
+    bool find(const ElementType& element, unsigned int hash, unsigned int& slot) const;
+
+    // firstEmpty() returns the empty slot in which an element with the
+    // given hash, known not to be in the table, belongs.
+    unsigned int firstEmpty(unsigned int hash) const noexcept;
+
+    // setControl() marks a slot as holding an element with the given hash.
+    void setControl(unsigned int slot, unsigned int hash) noexcept;
+
+    // grow() moves the elements into a table twice as large.
+    void grow();
+};
+
+
+
+namespace impl_
+{
+    // A FlatHashSet__Group is the GROUP_WIDTH control bytes examined at
+    // once by a FlatHashSet lookup; each match() returns a mask with bit i
+    // set where byte i matches.
+    class FlatHashSet__Group
+    {
+    public:
+        explicit FlatHashSet__Group(const signed char* control) noexcept
+        {
+#if defined(__SSE2__)
+            bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(control));
+#else
+            std::memcpy(bytes, control, sizeof(bytes));
+#endif
+        }
+
+
+        unsigned int matchFingerprint(signed char fingerprint) const noexcept
+        {
+#if defined(__SSE2__)
+            return _mm_movemask_epi8(_mm_cmpeq_epi8(bytes, _mm_set1_epi8(fingerprint)));
+#else
+            unsigned int mask = 0;
+            for(unsigned int i = 0; i < sizeof(bytes); i++)
+            {
+                mask |= unsigned(bytes[i] == fingerprint) << i;
+            }
+            return mask;
+#endif
+        }
+
+
+        // Only EMPTY control bytes have their high bit set.
+        unsigned int matchEmpty() const noexcept
+        {
+#if defined(__SSE2__)
+            return _mm_movemask_epi8(bytes);
+#else
+            unsigned int mask = 0;
+            for(unsigned int i = 0; i < sizeof(bytes); i++)
+            {
+                mask |= unsigned(bytes[i] < 0) << i;
+            }
+            return mask;
+#endif
+        }
+
+
+    private:
+#if defined(__SSE2__)
+        __m128i bytes;
+#else
+        signed char bytes[16];
+#endif
+    };
+
+
+    inline unsigned int FlatHashSet__lowestBit(unsigned int mask) noexcept
+    {
+        return __builtin_ctz(mask);
+    }
+}
+
+
+
+template <typename ElementType>
+FlatHashSet<ElementType>::FlatHashSet(HashFunction hashFunction)
+    : hashFunction{hashFunction}, control{nullptr}, slots{nullptr}, sz{0}, cp{0}
+{
+    allocate(DEFAULT_CAPACITY);
+}
+
+
+template <typename ElementType>
+FlatHashSet<ElementType>::~FlatHashSet() noexcept
+{
+    release();
+}
+
+
+template <typename ElementType>
+FlatHashSet<ElementType>::FlatHashSet(const FlatHashSet& s)
+    : hashFunction{s.hashFunction}, control{nullptr}, slots{nullptr}, sz{0}, cp{0}
+{
+    if(s.control == nullptr)
+    {
+        return;
+    }
+    allocate(s.cp);
+    try
+    {
+        // A slot is only marked full once its element is constructed, so
+        // release() can clean up after a copy that throws.
+        for(unsigned int i = 0; i < cp; i++)
+        {
+            if(s.control[i] != EMPTY)
+            {
+                new (slots + i) ElementType{s.slots[i]};
+                control[i] = s.control[i];
+                if(i < GROUP_WIDTH - 1)
+                {
+                    control[cp + i] = s.control[i];
+                }
+                sz++;
+            }
+        }
+    }
+    catch(...)
+    {
+        release();
+        throw;
+    }
+}
+
+
+template <typename ElementType>
+FlatHashSet<ElementType>::FlatHashSet(FlatHashSet&& s)
+    : hashFunction{s.hashFunction}, control{s.control}, slots{s.slots}, sz{s.sz}, cp{s.cp}
+{
+    s.control = nullptr;
+    s.slots = nullptr;
+    s.sz = 0;
+    s.cp = 0;
+}
+
+
+template <typename ElementType>
+FlatHashSet<ElementType>& FlatHashSet<ElementType>::operator=(const FlatHashSet& s)
+{
+    if(this != &s)
+    {
+        FlatHashSet copy{s};
+        *this = std::move(copy);
+    }
+    return *this;
+}
+
+
+template <typename ElementType>
+FlatHashSet<ElementType>& FlatHashSet<ElementType>::operator=(FlatHashSet&& s) noexcept
+{
+    std::swap(hashFunction, s.hashFunction);
+    std::swap(control, s.control);
+    std::swap(slots, s.slots);
+    std::swap(sz, s.sz);
+    std::swap(cp, s.cp);
+    return *this;
+}
+
+
+template <typename ElementType>
+bool FlatHashSet<ElementType>::isImplemented() const noexcept
+{
+    return true;
+}
+
+
+template <typename ElementType>
+void FlatHashSet<ElementType>::add(const ElementType& element)
+{
+    if(control == nullptr)
+    {
+        allocate(DEFAULT_CAPACITY);
+    }
+    unsigned int hash = hashFunction(element);
+    unsigned int slot;
+    if(find(element, hash, slot))
+    {
+        return;
+    }
+
+    if(sz + 1 > cp / 8 * 7)
+    {
+        grow();
+        slot = firstEmpty(hash);
+    }
+    new (slots + slot) ElementType{element};
+    setControl(slot, hash);
+    sz++;
+}
+
+
+template <typename ElementType>
+bool FlatHashSet<ElementType>::contains(const ElementType& element) const
+{
+    // A FlatHashSet that has been moved from has no table to search.
+    if(sz == 0)
+    {
+        return false;
+    }
+    unsigned int slot;
+    return find(element, hashFunction(element), slot);
+}
+
+
+template <typename ElementType>
+unsigned int FlatHashSet<ElementType>::size() const noexcept
+{
+    return sz;
+}
+
+
+template <typename ElementType>
+unsigned int FlatHashSet<ElementType>::capacity() const noexcept
+{
+    return cp;
+}
+
+
+template <typename ElementType>
+void FlatHashSet<ElementType>::allocate(unsigned int capacity)
+{
+    signed char* newControl = new signed char[capacity + GROUP_WIDTH - 1];
+    try
+    {
+        slots = std::allocator<ElementType>{}.allocate(capacity);
+    }
+    catch(...)
+    {
+        delete[] newControl;
+        throw;
+    }
+    std::memset(newControl, EMPTY, capacity + GROUP_WIDTH - 1);
+    control = newControl;
+    cp = capacity;
+    sz = 0;
+}
+
+
+template <typename ElementType>
+void FlatHashSet<ElementType>::release() noexcept
+{
+    if(control == nullptr)
+    {
+        return;
+    }
+    for(unsigned int i = 0; i < cp; i++)
+    {
+        if(control[i] != EMPTY)
+        {
+            slots[i].~ElementType();
+        }
+    }
+    std::allocator<ElementType>{}.deallocate(slots, cp);
+    delete[] control;
+    control = nullptr;
+    slots = nullptr;
+}
+
+
+template <typename ElementType>
+bool FlatHashSet<ElementType>::find(const ElementType& element, unsigned int hash, unsigned int& slot) const
+{
+    // Groups are visited at triangular-number offsets, which, with a
+    // power-of-two capacity, reach every group before repeating one.
+    signed char fingerprint = hash & 0x7f;
+    unsigned int mask = cp - 1;
+    unsigned int position = (hash >> 7) & mask;
+    unsigned int groups = 0;
+    for(unsigned int step = GROUP_WIDTH; ; step += GROUP_WIDTH)
+    {
+        groups++;
+        impl_::FlatHashSet__Group group{control + position};
+        for(unsigned int matches = group.matchFingerprint(fingerprint); matches != 0; matches &= matches - 1)
+        {
+            unsigned int candidate = (position + impl_::FlatHashSet__lowestBit(matches)) & mask;
+            if(slots[candidate] == element)
+            {
+                slot = candidate;
+                SPELLCHECK_COUNT(flatHashSetContains, 1);
+                SPELLCHECK_COUNT(flatHashSetGroups, groups);
+                return true;
+            }
+        }
+        unsigned int empties = group.matchEmpty();
+        if(empties != 0)
+        {
+            slot = (position + impl_::FlatHashSet__lowestBit(empties)) & mask;
+            SPELLCHECK_COUNT(flatHashSetContains, 1);
+            SPELLCHECK_COUNT(flatHashSetGroups, groups);
+            return false;
+        }
+        position = (position + step) & mask;
+    }
+}
+
+
+template <typename ElementType>
+unsigned int FlatHashSet<ElementType>::firstEmpty(unsigned int hash) const noexcept
+{
+    unsigned int mask = cp - 1;
+    unsigned int position = (hash >> 7) & mask;
+    for(unsigned int step = GROUP_WIDTH; ; step += GROUP_WIDTH)
+    {
+        unsigned int empties = impl_::FlatHashSet__Group{control + position}.matchEmpty();
+        if(empties != 0)
+        {
+            return (position + impl_::FlatHashSet__lowestBit(empties)) & mask;
+        }
+        position = (position + step) & mask;
+    }
+}
+
+
+template <typename ElementType>
+void FlatHashSet<ElementType>::setControl(unsigned int slot, unsigned int hash) noexcept
+{
+    signed char fingerprint = hash & 0x7f;
+    control[slot] = fingerprint;
+    if(slot < GROUP_WIDTH - 1)
+    {
+        control[cp + slot] = fingerprint;
+    }
+}
+
+
+template <typename ElementType>
+void FlatHashSet<ElementType>::grow()
+{
+    SPELLCHECK_COUNT(flatHashSetResizes, 1);
+    signed char* oldControl = control;
+    ElementType* oldSlots = slots;
+    unsigned int oldCp = cp;
+    unsigned int oldSz = sz;
+    allocate(oldCp * 2);
+
+    // Every element is known to be distinct, so each goes straight into
+    // the first empty slot along its probe sequence.
+    for(unsigned int i = 0; i < oldCp; i++)
+    {
+        if(oldControl[i] != EMPTY)
+        {
+            unsigned int hash = hashFunction(oldSlots[i]);
+            unsigned int slot = firstEmpty(hash);
+            new (slots + slot) ElementType{std::move(oldSlots[i])};
+            setControl(slot, hash);
+            oldSlots[i].~ElementType();
+        }
+    }
+    sz = oldSz;
+
+    std::allocator<ElementType>{}.deallocate(oldSlots, oldCp);
+    delete[] oldControl;
+}
+
+
+
+#endif // FLATHASHSET_HPP
@@ -14,6 +14,24 @@
 // elements as there are array cells), the HashSet should be resized so
 // that it is twice as large as it was before.
 //
+// Normally, the add() that crosses that threshold moves every element
+// into the new array before it returns.  A HashSet can instead resize
+// incrementally, for callers that add elements on latency-sensitive
+// threads, so that no one add() takes much longer than an ordinary one.
+// The new array is allocated without being initialized, and each add()
+// first clears a few more of its cells, then, once it's clear, moves a few
+// of the old array's chains into it, the two arrays being kept side by
+// side (and contains() looking in both) until the old one is empty.
+// contains() itself never moves anything, so that it remains safe to call
+// from many threads at once.
+//
+// The hash is a template parameter, Hash, a function object returning a
+// 64-bit hash, so that the compiler can inline it into add() and
+// contains(); by default, it's DefaultHash (see StringHash.hpp).  A
+// HashSet can still be given a HashFunction, as before, which is then
+// used instead, through an indirect call; a HashSet of a type that its
+// Hash can't hash (such as one without a std::hash) must be given one.
+//
 // You are not permitted to use the containers in the C++ Standard Library
 // (such as std::set, std::map, or std::vector) to store the information
 // in your data structure.  Instead, you'll need to use a dynamically-
@@ -23,32 +41,60 @@
 #ifndef HASHSET_HPP
 #define HASHSET_HPP
 
+#include <algorithm>
+#include <cstdint>
 #include <functional>
+#include <string_view>
+#include <type_traits>
+#include <utility>
 #include "Set.hpp"
+#include "Stats.hpp"
+#include "StringHash.hpp"
+#include "StringLookup.hpp"
 
+// Each node keeps its element's hash, so that resizing never has to hash
+// an element again, and most mismatches in a chain are found without
+// comparing elements.
 template <typename ElementType>
 struct NodeH
 {
     ElementType element;
+    std::uint64_t hash;
     NodeH<ElementType>* next;
 };
 
-template <typename ElementType>
-class HashSet : public Set<ElementType>
+template <typename ElementType, typename Hash = DefaultHash<ElementType>>
+class HashSet : public Set<ElementType>, public StringLookupFor<HashSet<ElementType, Hash>, ElementType>
 {
 public:
     // The default capacity of the HashSet before anything has been
     // added to it.
     static constexpr unsigned int DEFAULT_CAPACITY = 10;
 
+    // The number of the new array's cells that each add() clears, then the
+    // number of the old array's chains that each add() moves into the new
+    // array, during an incremental resize.  Together, they finish every
+    // resize in about half of the adds before the next one is due.
+    static constexpr int CLEARING_STEP = 16;
+    static constexpr int MIGRATION_STEP = 4;
+
     // A HashFunction is a function that takes a reference to a const
     // ElementType and returns an unsigned int.
     using HashFunction = std::function<unsigned int(const ElementType&)>;
 
 public:
     // Initializes a HashSet to be empty, so that it will use the given
-    // hash function whenever it needs to hash an element.
+    // Hash (or a default-constructed one) whenever it needs to hash an
+    // element.  If incrementalResize is true, the HashSet resizes
+    // incrementally.
+    HashSet();
+    HashSet(Hash hash, bool incrementalResize);
+
+    // Initializes a HashSet to be empty, so that it will use the given
+    // hash function, rather than its Hash, whenever it needs to hash an
+    // element.
     explicit HashSet(HashFunction hashFunction);
+    HashSet(HashFunction hashFunction, bool incrementalResize);
 
     // Cleans up the HashSet so that it leaks no memory.
     ~HashSet() noexcept override;
@@ -79,10 +125,12 @@ public:
     //
     //     capacity * 2 + 1
     //
-    // In the case where the array is resized, this function runs in linear
-    // time (with respect to the number of elements, assuming a good hash
-    // function); otherwise, it runs in constant time (again, assuming a good
-    // hash function).  The amortized running time is also constant.
+    // In the case where the array is resized all at once, this function runs
+    // in linear time (with respect to the number of elements, assuming a good
+    // hash function), moving the existing nodes into the new array without
+    // copying or rehashing them; otherwise, it runs in constant time (again,
+    // assuming a good hash function).  The amortized running time is also
+    // constant.
     void add(const ElementType& element) override;
 
 
@@ -91,6 +139,13 @@ public:
     // to the number of elements, assuming a good hash function).
     bool contains(const ElementType& element) const override;
 
+    // A HashSet of strings can also be searched for a std::string_view,
+    // which is hashed and compared in place if the Hash can hash a view
+    // and the HashSet wasn't given a HashFunction, and copied into a
+    // std::string otherwise.
+    template <typename Key, typename = std::enable_if_t<impl_::StringLookup__isKey<ElementType, Key>>>
+    bool contains(const Key& element) const;
+
 
     // size() returns the number of elements in the set.
     unsigned int size() const noexcept override;
@@ -98,7 +153,9 @@ public:
 
     // elementsAtIndex() returns the number of elements that hashed to a
     // particular index in the array.  If the index is out of the boundaries
-    // of the array, this function returns 0.
+    // of the array, this function returns 0.  During an incremental resize,
+    // the elements not yet moved count toward the index they'll be moved
+    // to, so this takes time proportional to the old array's capacity.
     unsigned int elementsAtIndex(unsigned int index) const;
 
 
@@ -109,10 +166,62 @@ public:
 
 
 private:
+    Hash hasher;
     HashFunction hashFunction;
     NodeH<ElementType>** arr;
     int sz;
     int cp;
+    bool incremental;
+
+    // During an incremental resize, nextArr is the new array until its
+    // first "cleared" cells have been cleared, after which oldArr is the
+    // array being emptied, whose chains before index "migrated" have been
+    // moved.  Otherwise, they're nullptr.
+    NodeH<ElementType>** nextArr;
+    int nextCp;
+    int cleared;
+    NodeH<ElementType>** oldArr;
+    int oldCp;
+    int migrated;
+
+    // hashOf() returns an element's hash: the hash function's, if this
+    // HashSet was given one, or else its Hash's.
+    std::uint64_t hashOf(const ElementType& element) const;
+
+    // indexOf() returns the index of the array cell, in an array with the
+    // given capacity, where an element with the given hash belongs.
+    static unsigned int indexOf(std::uint64_t hash, int capacity) noexcept;
+
+    // findInChain() returns the node in the chain holding the element
+    // (or one equal to the key) with the given hash, or nullptr, counting
+    // the nodes it walks.
+    template <typename Key>
+    static NodeH<ElementType>* findInChain(
+        NodeH<ElementType>* current, const Key& element, std::uint64_t hash, unsigned int& walked);
+
+    // containsHashed() is contains() for an element whose hash is known.
+    template <typename Key>
+    bool containsHashed(const Key& element, std::uint64_t hash) const;
+
+    // clearCells() clears up to CLEARING_STEP more of the next array's
+    // cells, then starts moving chains into it once it's clear.
+    void clearCells();
+
+    // startMigration() makes the given (clear) array the one to which
+    // elements are added, and the current one the array to be emptied.
+    void startMigration(NodeH<ElementType>** newArr, int newCp) noexcept;
+
+    // migrateChains() moves up to "count" of the old array's chains into
+    // the new one, and frees the old array once it's empty.
+    void migrateChains(int count);
+
+    // copyNodes() fills this HashSet's (empty) arrays with copies of the
+    // nodes in another's, which has the same capacities, keeping each
+    // chain in the same order.
+    void copyNodes(const HashSet& s);
+
+    // deleteNodes() deletes every node, and the arrays.
+    void deleteNodes() noexcept;
 };
 
 
@@ -120,37 +229,11 @@ private:
 namespace impl_
 {
     template <typename ElementType>
-    unsigned int HashSet__undefinedHashFunction(const ElementType& element)
-    {
-        return 0;
-    }
-}
-
-
-template <typename ElementType>
-HashSet<ElementType>::HashSet(HashFunction hashFunction)
-    : hashFunction{hashFunction}, arr{nullptr}, sz{0}, cp{DEFAULT_CAPACITY}
-{
-    try
-    {
-        arr = new NodeH<ElementType>*[DEFAULT_CAPACITY]{nullptr};
-    }
-    catch(...)
+    void HashSet__deleteChains(NodeH<ElementType>** array, int capacity) noexcept
     {
-        delete[] arr;
-        throw;
-    }   
-}
-
-
-template <typename ElementType>
-HashSet<ElementType>::~HashSet() noexcept
-{
-    if(arr != nullptr)
-    {
-        for(int i = 0; i < cp; i++)
+        for(int i = 0; i < capacity; i++)
         {
-            NodeH<ElementType>* current = arr[i];
+            NodeH<ElementType>* current = array[i];
             while(current != nullptr)
             {
                 NodeH<ElementType>* c = current->next;
@@ -158,219 +241,277 @@ HashSet<ElementType>::~HashSet() noexcept
                 current = c;
             }
         }
+        delete[] array;
     }
-    delete[] arr;
 }
 
 
-template <typename ElementType>
-HashSet<ElementType>::HashSet(const HashSet& s)
-    : hashFunction{s.hashFunction}, arr{nullptr},sz{s.sz}, cp{s.cp}
+template <typename ElementType, typename Hash>
+HashSet<ElementType, Hash>::HashSet()
+    : HashSet{Hash{}, false}
+{
+}
+
+
+template <typename ElementType, typename Hash>
+HashSet<ElementType, Hash>::HashSet(Hash hash, bool incrementalResize)
+    : hasher{std::move(hash)}, hashFunction{}, arr{nullptr}, sz{0}, cp{DEFAULT_CAPACITY},
+      incremental{incrementalResize}, nextArr{nullptr}, nextCp{0}, cleared{0}, oldArr{nullptr}, oldCp{0}, migrated{0}
+{
+    static_assert(std::is_invocable_v<const Hash&, const ElementType&>,
+                  "this Hash can't hash an ElementType; give the HashSet a HashFunction instead");
+    arr = new NodeH<ElementType>*[DEFAULT_CAPACITY]{nullptr};
+}
+
+
+template <typename ElementType, typename Hash>
+HashSet<ElementType, Hash>::HashSet(HashFunction hashFunction)
+    : HashSet{std::move(hashFunction), false}
+{
+}
+
+
+template <typename ElementType, typename Hash>
+HashSet<ElementType, Hash>::HashSet(HashFunction hashFunction, bool incrementalResize)
+    : hasher{}, hashFunction{std::move(hashFunction)}, arr{nullptr}, sz{0}, cp{DEFAULT_CAPACITY},
+      incremental{incrementalResize}, nextArr{nullptr}, nextCp{0}, cleared{0}, oldArr{nullptr}, oldCp{0}, migrated{0}
+{
+    arr = new NodeH<ElementType>*[DEFAULT_CAPACITY]{nullptr};
+}
+
+
+template <typename ElementType, typename Hash>
+HashSet<ElementType, Hash>::~HashSet() noexcept
+{
+    deleteNodes();
+}
+
+
+template <typename ElementType, typename Hash>
+HashSet<ElementType, Hash>::HashSet(const HashSet& s)
+    : hasher{s.hasher}, hashFunction{s.hashFunction}, arr{nullptr}, sz{s.sz}, cp{s.cp}, incremental{s.incremental},
+      nextArr{nullptr}, nextCp{0}, cleared{0}, oldArr{nullptr}, oldCp{s.oldCp}, migrated{s.migrated}
 {
+    // A resize that hasn't gotten past clearing the next array is started
+    // over by the copy's next add().
     try
     {
         arr = new NodeH<ElementType>*[cp]{nullptr};
+        if(s.oldArr != nullptr)
+        {
+            oldArr = new NodeH<ElementType>*[oldCp]{nullptr};
+        }
+        copyNodes(s);
     }
     catch(...)
     {
-        delete[] arr;
+        deleteNodes();
         throw;
     }
-    for(int i = 0; i < cp; i++)
-    {
-        NodeH<ElementType>* current = arr[i];
-        NodeH<ElementType>* source = s.arr[i];
-        if(source != nullptr)
-        {
-            current = new NodeH<ElementType>{source->element, nullptr};
-            source = source->next;
-        }
-        while(source != nullptr)
-        {
-            current->next = new NodeH<ElementType>{source->element, nullptr};
-            current = current->next;
-            source = source->next;
-        }
-    }
 }
 
 
-template <typename ElementType>
-HashSet<ElementType>::HashSet(HashSet&& s) noexcept
+template <typename ElementType, typename Hash>
+HashSet<ElementType, Hash>::HashSet(HashSet&& s) noexcept
+    : hasher{std::move(s.hasher)}, hashFunction{std::move(s.hashFunction)}, arr{s.arr}, sz{s.sz}, cp{s.cp}, incremental{s.incremental},
+      nextArr{s.nextArr}, nextCp{s.nextCp}, cleared{s.cleared}, oldArr{s.oldArr}, oldCp{s.oldCp}, migrated{s.migrated}
 {
-    hashFunction = std::move(s.hashFunction);
-    sz = std::move(s.sz);
-    cp = std::move(s.cp);
-    arr = s.arr;
     s.arr = nullptr;
+    s.nextArr = nullptr;
+    s.oldArr = nullptr;
 }
 
 
-template <typename ElementType>
-HashSet<ElementType>& HashSet<ElementType>::operator=(const HashSet& s)
+template <typename ElementType, typename Hash>
+HashSet<ElementType, Hash>& HashSet<ElementType, Hash>::operator=(const HashSet& s)
 {
     if(this != &s)
     {
-        for(int i = 0; i < cp; i++)
-        {
-            NodeH<ElementType>* current = arr[i];
-            while(current != nullptr)
-            {
-                NodeH<ElementType>* c = current->next;
-                delete current;
-                current = c;
-            }
-        }
-        delete[] arr;
-        hashFunction = s.hashFunction;
-        sz = s.sz;
-        cp = s.cp;
-        arr = new NodeH<ElementType>*[cp]{nullptr};
-        for(int i = 0; i < cp; i++)
-        {
-            NodeH<ElementType>* current = arr[i];
-            NodeH<ElementType>* source = s.arr[i];
-            if(source != nullptr)
-            {
-                current = new NodeH<ElementType>{source->element, nullptr};
-                source = source->next;
-            }
-            while(source != nullptr)
-            {
-                current->next = new NodeH<ElementType>{source->element, nullptr};
-                current = current->next;
-                source = source->next;
-            }
-        }
+        HashSet copy{s};
+        *this = std::move(copy);
     }
     return *this;
 }
 
 
-template <typename ElementType>
-HashSet<ElementType>& HashSet<ElementType>::operator=(HashSet&& s) noexcept
+template <typename ElementType, typename Hash>
+HashSet<ElementType, Hash>& HashSet<ElementType, Hash>::operator=(HashSet&& s) noexcept
 {
-    for(int i = 0; i < cp; i++)
+    if(this == &s)
     {
-        NodeH<ElementType>* current = arr[i];
-        while(current != nullptr)
-        {
-            NodeH<ElementType>* c = current->next;
-            delete current;
-            current = c;
-        }
+        return *this;
     }
-    delete[] arr;
+    deleteNodes();
+    hasher = std::move(s.hasher);
     hashFunction = std::move(s.hashFunction);
-    sz = std::move(s.sz);
-    cp = std::move(s.cp);
+    sz = s.sz;
+    cp = s.cp;
+    incremental = s.incremental;
     arr = s.arr;
+    nextArr = s.nextArr;
+    nextCp = s.nextCp;
+    cleared = s.cleared;
+    oldArr = s.oldArr;
+    oldCp = s.oldCp;
+    migrated = s.migrated;
     s.arr = nullptr;
+    s.nextArr = nullptr;
+    s.oldArr = nullptr;
     return *this;
 }
 
 
-template <typename ElementType>
-bool HashSet<ElementType>::isImplemented() const noexcept
+template <typename ElementType, typename Hash>
+bool HashSet<ElementType, Hash>::isImplemented() const noexcept
 {
     return true;
 }
 
 
-template <typename ElementType>
-void HashSet<ElementType>::add(const ElementType& element)
+template <typename ElementType, typename Hash>
+void HashSet<ElementType, Hash>::add(const ElementType& element)
 {
-    if(!contains(element))
+    std::uint64_t hash = hashOf(element);
+    if(containsHashed(element, hash))
     {
-        sz++;
-    
-        if((double(sz) / double(cp)) > 0.8)
+        return;
+    }
+
+    // The node is made first, so that nothing changes if that throws.
+    NodeH<ElementType>* node = new NodeH<ElementType>{element, hash, nullptr};
+    if(nextArr != nullptr)
+    {
+        clearCells();
+    }
+    else if(oldArr != nullptr)
+    {
+        migrateChains(MIGRATION_STEP);
+    }
+    else if((double(sz + 1) / double(cp)) > 0.8)
+    {
+        SPELLCHECK_COUNT(hashSetResizes, 1);
+        try
         {
-            int oldCp = cp;
-            cp = cp * 2 + 1;
-            NodeH<ElementType>** newArr = new NodeH<ElementType>*[cp]{nullptr};
-            for(int i = 0; i < oldCp; i++)
+            if(incremental)
             {
-                NodeH<ElementType>* current = arr[i];
-                while(current != nullptr)
-                {
-                    int newIndex = hashFunction(current->element) % cp;
-                    NodeH<ElementType>* newCur = newArr[newIndex];
-                    if(newCur == nullptr)
-                    {
-                        newArr[newIndex] = new NodeH<ElementType>{current->element, nullptr};
-                    }
-                    else
-                    {
-                        while(newCur-> next != nullptr)
-                        {
-                            newCur = newCur->next;
-                        }
-                        newCur->next = new NodeH<ElementType>{current->element, nullptr};
-                    }
-                    current = current->next;
-                }
+                nextArr = new NodeH<ElementType>*[cp * 2 + 1];
+                nextCp = cp * 2 + 1;
+                cleared = 0;
             }
-            for(int i = 0; i < oldCp; i++)
+            else
             {
-                NodeH<ElementType>* current = arr[i];
-                while(current != nullptr)
-                {
-                    NodeH<ElementType>* c = current->next;
-                    delete current;
-                    current = c;
-                }
+                startMigration(new NodeH<ElementType>*[cp * 2 + 1]{nullptr}, cp * 2 + 1);
+                migrateChains(oldCp);
             }
-            delete[] arr;
-            arr = newArr;
         }
-        int index = hashFunction(element) % cp;
-        NodeH<ElementType>* current = arr[index];
-        if(current == nullptr)
+        catch(...)
         {
-            arr[index] = new NodeH<ElementType>{element, nullptr};
+            delete node;
+            throw;
         }
-        else
+    }
+
+    sz++;
+    unsigned int index = indexOf(hash, cp);
+    node->next = arr[index];
+    arr[index] = node;
+}
+
+
+template <typename ElementType, typename Hash>
+bool HashSet<ElementType, Hash>::contains(const ElementType& element) const
+{
+    return containsHashed(element, hashOf(element));
+}
+
+
+template <typename ElementType, typename Hash>
+template <typename Key, typename>
+bool HashSet<ElementType, Hash>::contains(const Key& element) const
+{
+    std::string_view view{element};
+    if constexpr(std::is_invocable_v<const Hash&, std::string_view>)
+    {
+        if(!hashFunction)
         {
-            while(current->next != nullptr)
-            {
-                current = current->next;
-            }
-            current->next = new NodeH<ElementType>{element, nullptr};
+            return containsHashed(view, hasher(view));
         }
     }
+    return contains(ElementType{view});
 }
 
 
-template <typename ElementType>
-bool HashSet<ElementType>::contains(const ElementType& element) const
+template <typename ElementType, typename Hash>
+std::uint64_t HashSet<ElementType, Hash>::hashOf(const ElementType& element) const
+{
+    // A Hash that can't hash an ElementType (such as the DefaultHash of a
+    // type without a std::hash) is never called, since the HashSet must
+    // then have been given a hash function.
+    if constexpr(std::is_invocable_v<const Hash&, const ElementType&>)
+    {
+        if(!hashFunction)
+        {
+            return hasher(element);
+        }
+    }
+    return hashFunction(element);
+}
+
+
+template <typename ElementType, typename Hash>
+unsigned int HashSet<ElementType, Hash>::indexOf(std::uint64_t hash, int capacity) noexcept
+{
+    // Folding the hash to 32 bits first makes this a 32-bit division.
+    return std::uint32_t(hash ^ (hash >> 32)) % unsigned(capacity);
+}
+
+
+template <typename ElementType, typename Hash>
+template <typename Key>
+NodeH<ElementType>* HashSet<ElementType, Hash>::findInChain(
+    NodeH<ElementType>* current, const Key& element, std::uint64_t hash, unsigned int& walked)
 {
-    int index = hashFunction(element) % cp;
-    NodeH<ElementType>* current = arr[index];
     while(current != nullptr)
     {
-        if(current->element == element)
+        walked++;
+        if(current->hash == hash && current->element == element)
         {
-            return true;
+            break;
         }
         current = current->next;
     }
-    return false;
+    return current;
 }
 
 
-template <typename ElementType>
-unsigned int HashSet<ElementType>::size() const noexcept
+template <typename ElementType, typename Hash>
+template <typename Key>
+bool HashSet<ElementType, Hash>::containsHashed(const Key& element, std::uint64_t hash) const
+{
+    unsigned int walked = 0;
+    NodeH<ElementType>* found = findInChain(arr[indexOf(hash, cp)], element, hash, walked);
+    if(found == nullptr && oldArr != nullptr)
+    {
+        found = findInChain(oldArr[indexOf(hash, oldCp)], element, hash, walked);
+    }
+    SPELLCHECK_COUNT(hashSetContains, 1);
+    SPELLCHECK_COUNT(hashSetChainNodes, walked);
+    return found != nullptr;
+}
+
+
+template <typename ElementType, typename Hash>
+unsigned int HashSet<ElementType, Hash>::size() const noexcept
 {
     return sz;
 }
 
 
-template <typename ElementType>
-unsigned int HashSet<ElementType>::elementsAtIndex(unsigned int index) const
+template <typename ElementType, typename Hash>
+unsigned int HashSet<ElementType, Hash>::elementsAtIndex(unsigned int index) const
 {
     int result = 0;
-    if (index > cp)
+    if(index >= unsigned(cp))
     {
         return result;
     }
@@ -380,14 +521,27 @@ unsigned int HashSet<ElementType>::elementsAtIndex(unsigned int index) const
         result++;
         current = current->next;
     }
+    if(oldArr != nullptr)
+    {
+        for(int i = migrated; i < oldCp; i++)
+        {
+            for(current = oldArr[i]; current != nullptr; current = current->next)
+            {
+                if(indexOf(current->hash, cp) == index)
+                {
+                    result++;
+                }
+            }
+        }
+    }
     return result;
 }
 
 
-template <typename ElementType>
-bool HashSet<ElementType>::isElementAtIndex(const ElementType& element, unsigned int index) const
+template <typename ElementType, typename Hash>
+bool HashSet<ElementType, Hash>::isElementAtIndex(const ElementType& element, unsigned int index) const
 {
-    if(index > cp)
+    if(index >= unsigned(cp))
     {
         return false;
     }
@@ -400,10 +554,115 @@ bool HashSet<ElementType>::isElementAtIndex(const ElementType& element, unsigned
         }
         current = current->next;
     }
+    if(oldArr != nullptr)
+    {
+        std::uint64_t hash = hashOf(element);
+        unsigned int walked = 0;
+        return indexOf(hash, cp) == index && findInChain(oldArr[indexOf(hash, oldCp)], element, hash, walked) != nullptr;
+    }
     return false;
 }
 
 
+template <typename ElementType, typename Hash>
+void HashSet<ElementType, Hash>::clearCells()
+{
+    SPELLCHECK_TIME(hashSetResizeNanoseconds);
+    int last = std::min(nextCp, cleared + CLEARING_STEP);
+    std::fill(nextArr + cleared, nextArr + last, nullptr);
+    cleared = last;
+    if(cleared == nextCp)
+    {
+        startMigration(nextArr, nextCp);
+        nextArr = nullptr;
+    }
+}
+
+
+template <typename ElementType, typename Hash>
+void HashSet<ElementType, Hash>::startMigration(NodeH<ElementType>** newArr, int newCp) noexcept
+{
+    oldArr = arr;
+    oldCp = cp;
+    migrated = 0;
+    arr = newArr;
+    cp = newCp;
+}
+
+
+template <typename ElementType, typename Hash>
+void HashSet<ElementType, Hash>::migrateChains(int count)
+{
+    SPELLCHECK_TIME(hashSetResizeNanoseconds);
+
+    // Each node is unlinked from its old chain and pushed onto the front of
+    // its new one.
+    int last = std::min(oldCp, migrated + count);
+    for(; migrated < last; migrated++)
+    {
+        NodeH<ElementType>* current = oldArr[migrated];
+        while(current != nullptr)
+        {
+            NodeH<ElementType>* next = current->next;
+            unsigned int newIndex = indexOf(current->hash, cp);
+            current->next = arr[newIndex];
+            arr[newIndex] = current;
+            current = next;
+        }
+        oldArr[migrated] = nullptr;
+    }
+
+    if(migrated == oldCp)
+    {
+        delete[] oldArr;
+        oldArr = nullptr;
+        oldCp = 0;
+        migrated = 0;
+    }
+}
 
-#endif // HASHSET_HPP
 
+template <typename ElementType, typename Hash>
+void HashSet<ElementType, Hash>::copyNodes(const HashSet& s)
+{
+    auto copyChains = [](NodeH<ElementType>** to, NodeH<ElementType>** from, int capacity)
+    {
+        for(int i = 0; i < capacity; i++)
+        {
+            NodeH<ElementType>** tail = &to[i];
+            for(NodeH<ElementType>* source = from[i]; source != nullptr; source = source->next)
+            {
+                *tail = new NodeH<ElementType>{source->element, source->hash, nullptr};
+                tail = &(*tail)->next;
+            }
+        }
+    };
+
+    copyChains(arr, s.arr, cp);
+    if(oldArr != nullptr)
+    {
+        copyChains(oldArr, s.oldArr, oldCp);
+    }
+}
+
+
+template <typename ElementType, typename Hash>
+void HashSet<ElementType, Hash>::deleteNodes() noexcept
+{
+    if(arr != nullptr)
+    {
+        impl_::HashSet__deleteChains(arr, cp);
+        arr = nullptr;
+    }
+    if(oldArr != nullptr)
+    {
+        impl_::HashSet__deleteChains(oldArr, oldCp);
+        oldArr = nullptr;
+    }
+    delete[] nextArr;
+    nextArr = nullptr;
+}
+
+
+
+#endif // HASHSET_HPP
@@ -0,0 +1,89 @@
+// KeyboardLayout.cpp
+
+#include "KeyboardLayout.hpp"
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+
+
+
+namespace
+{
+    // Keys whose centers are at most this many key widths apart are
+    // neighbors: those beside a key, and those above and below it on either
+    // side, however the rows are staggered.
+    constexpr double NEIGHBOR_DISTANCE = 1.5;
+
+
+    struct Key
+    {
+        char letter;
+        double x;
+        double y;
+    };
+
+
+    bool isAsciiUpper(char c)
+    {
+        return c >= 'A' && c <= 'Z';
+    }
+}
+
+
+
+KeyboardLayout::KeyboardLayout(const std::vector<std::string>& rows, const std::vector<double>& offsets)
+{
+    std::vector<Key> keys;
+    for(std::size_t r = 0; r < rows.size(); r++)
+    {
+        double offset = r < offsets.size() ? offsets[r] : 0.0;
+        for(std::size_t c = 0; c < rows[r].length(); c++)
+        {
+            keys.push_back(Key{rows[r][c], c + offset, double(r)});
+        }
+    }
+
+    std::vector<std::pair<double, std::size_t>> near;
+    for(const Key& key : keys)
+    {
+        near.clear();
+        for(std::size_t k = 0; k < keys.size(); k++)
+        {
+            double distance = std::hypot(keys[k].x - key.x, keys[k].y - key.y);
+            if(keys[k].letter != key.letter && distance <= NEIGHBOR_DISTANCE)
+            {
+                near.emplace_back(distance, k);
+            }
+        }
+        // Ties are broken by the order of the keys in the rows.
+        std::sort(near.begin(), near.end());
+
+        std::string& upper = adjacent[static_cast<unsigned char>(key.letter)];
+        for(const auto& n : near)
+        {
+            upper.push_back(keys[n.second].letter);
+        }
+
+        if(isAsciiUpper(key.letter))
+        {
+            std::string& lower = adjacent[static_cast<unsigned char>(std::tolower(key.letter))];
+            for(char letter : upper)
+            {
+                lower.push_back(isAsciiUpper(letter) ? char(std::tolower(letter)) : letter);
+            }
+        }
+    }
+}
+
+
+const KeyboardLayout& KeyboardLayout::qwerty()
+{
+    static const KeyboardLayout layout{{"QWERTYUIOP", "ASDFGHJKL", "ZXCVBNM"}, {0.0, 0.25, 0.75}};
+    return layout;
+}
+
+
+std::string_view KeyboardLayout::neighbors(char key) const noexcept
+{
+    return adjacent[static_cast<unsigned char>(key)];
+}
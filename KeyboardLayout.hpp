@@ -0,0 +1,47 @@
+// KeyboardLayout.hpp
+//
+// A KeyboardLayout describes where the keys of a keyboard are relative to
+// one another, so that the letters a typist was most likely to have hit by
+// mistake (the keys next to the one intended) can be tried first when
+// correcting a typo (see WordChecker::findLikelySuggestions()).
+//
+// A layout is given as rows of keys, each shifted right by some fraction
+// of a key's width, as the rows of a physical keyboard are staggered; two
+// keys are neighbors when their centers are no more than 1.5 key widths
+// apart.  The rows are written with uppercase letters, and a lowercase
+// ASCII letter has the same neighbors as its uppercase form, in lowercase.
+
+#ifndef KEYBOARDLAYOUT_HPP
+#define KEYBOARDLAYOUT_HPP
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+
+
+class KeyboardLayout
+{
+public:
+    // Initializes a layout with the given rows of keys, top row first.  Row
+    // i is shifted right by offsets[i] key widths (0 where no offset is
+    // given).
+    KeyboardLayout(const std::vector<std::string>& rows, const std::vector<double>& offsets);
+
+
+    // qwerty() returns the US QWERTY layout.
+    static const KeyboardLayout& qwerty();
+
+
+    // neighbors() returns the keys next to the given one, nearest first (or
+    // nothing, for a key that isn't in the layout).
+    std::string_view neighbors(char key) const noexcept;
+
+
+private:
+    std::string adjacent[256];
+};
+
+
+
+#endif // KEYBOARDLAYOUT_HPP
@@ -0,0 +1,349 @@
+// LengthBucketIndex.cpp
+
+#include "LengthBucketIndex.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <string_view>
+#include <utility>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define LENGTHBUCKET_X86 1
+#else
+#define LENGTHBUCKET_X86 0
+#endif
+
+
+
+namespace
+{
+    // The longest word that can be the pattern of the bit-parallel
+    // computation, which keeps one bit per character of it.
+    constexpr std::size_t MAX_PATTERN_LENGTH = 64;
+
+
+    // The cancellation token is checked once per this many words scanned
+    // (a multiple of 4, the words compared at a time).
+    constexpr std::size_t CANCELLATION_INTERVAL = 1024;
+
+
+    // A Pattern is the misspelled word as the bit-parallel computation sees
+    // it: for each byte, a mask with bit i set where character i of the
+    // word is that byte, along with the bit of the word's last character.
+    struct Pattern
+    {
+        std::uint64_t masks[256];
+        std::uint64_t last;
+        unsigned int length;
+    };
+
+
+    void buildPattern(const std::string& word, Pattern& pattern)
+    {
+        std::fill(std::begin(pattern.masks), std::end(pattern.masks), 0);
+        for(std::size_t i = 0; i < word.length(); i++)
+        {
+            pattern.masks[static_cast<unsigned char>(word[i])] |= std::uint64_t{1} << i;
+        }
+        pattern.last = std::uint64_t{1} << (word.length() - 1);
+        pattern.length = word.length();
+    }
+
+
+    // bitParallelDistance() returns the distance between the pattern and
+    // the n characters of the given text, or limit + 1 if it's larger than
+    // limit.  Each iteration computes the next column of the dynamic
+    // programming table, encoded as vertical (vp/vn) and horizontal (hp/hn)
+    // differences between adjacent cells; "score" follows the bottom row.
+    // The tr term is Hyyro's extension for swaps of adjacent characters.
+    unsigned int bitParallelDistance(const Pattern& pattern, const char* text, std::size_t n, unsigned int limit)
+    {
+        std::uint64_t vp = ~std::uint64_t{0};
+        std::uint64_t vn = 0;
+        std::uint64_t d0 = 0;
+        std::uint64_t previousEq = 0;
+        std::size_t score = pattern.length;
+
+        for(std::size_t j = 0; j < n; j++)
+        {
+            std::uint64_t eq = pattern.masks[static_cast<unsigned char>(text[j])];
+            std::uint64_t tr = (((~d0) & eq) << 1) & previousEq;
+            d0 = (((eq & vp) + vp) ^ vp) | eq | vn | tr;
+            std::uint64_t hp = vn | ~(d0 | vp);
+            std::uint64_t hn = d0 & vp;
+            score += (hp & pattern.last) != 0;
+            score -= (hn & pattern.last) != 0;
+            std::uint64_t x = (hp << 1) | 1;
+            vn = x & d0;
+            vp = (hn << 1) | ~(x | d0);
+            previousEq = eq;
+
+            // Each remaining column can lower the score by at most one.
+            if(score > limit + (n - j - 1))
+            {
+                return limit + 1;
+            }
+        }
+        return std::min<std::size_t>(score, limit + 1);
+    }
+
+
+    // A DistancesFunction computes bitParallelDistance() on four texts of n
+    // characters each, stored back to back, storing the four distances in
+    // "distances".
+    using DistancesFunction = void (*)(const Pattern& pattern, const char* text, std::size_t n,
+                                       unsigned int limit, unsigned int* distances);
+
+
+    void scalarDistances(const Pattern& pattern, const char* text, std::size_t n, unsigned int limit,
+                         unsigned int* distances)
+    {
+        for(int lane = 0; lane < 4; lane++)
+        {
+            distances[lane] = bitParallelDistance(pattern, text + lane * n, n, limit);
+        }
+    }
+
+
+#if LENGTHBUCKET_X86
+    using Lanes = std::uint64_t __attribute__((vector_size(32)));
+    using LaneScores = std::int64_t __attribute__((vector_size(32)));
+
+
+    // avx2Distances() runs the four computations in the four lanes of AVX2
+    // vectors.  (Without AVX2, the vectors would be split in two, and that
+    // turns out slower than scalarDistances().)
+    __attribute__((target("avx2")))
+    void avx2Distances(const Pattern& pattern, const char* text, std::size_t n, unsigned int limit,
+                       unsigned int* distances)
+    {
+        Lanes vp = ~Lanes{};
+        Lanes vn = Lanes{};
+        Lanes d0 = Lanes{};
+        Lanes previousEq = Lanes{};
+        LaneScores score = LaneScores{} + static_cast<std::int64_t>(pattern.length);
+        const unsigned char* t = reinterpret_cast<const unsigned char*>(text);
+
+        for(std::size_t j = 0; j < n; j++)
+        {
+            Lanes eq = {pattern.masks[t[j]], pattern.masks[t[n + j]],
+                        pattern.masks[t[2 * n + j]], pattern.masks[t[3 * n + j]]};
+            Lanes tr = (((~d0) & eq) << 1) & previousEq;
+            d0 = (((eq & vp) + vp) ^ vp) | eq | vn | tr;
+            Lanes hp = vn | ~(d0 | vp);
+            Lanes hn = d0 & vp;
+
+            // A comparison yields -1 in each lane where it holds.
+            score -= (LaneScores)((hp & pattern.last) != 0);
+            score += (LaneScores)((hn & pattern.last) != 0);
+            Lanes x = (hp << 1) | 1;
+            vn = x & d0;
+            vp = (hn << 1) | ~(x | d0);
+            previousEq = eq;
+
+            LaneScores over = score > static_cast<std::int64_t>(limit + (n - j - 1));
+            if(over[0] & over[1] & over[2] & over[3])
+            {
+                std::fill(distances, distances + 4, limit + 1);
+                return;
+            }
+        }
+        for(int lane = 0; lane < 4; lane++)
+        {
+            distances[lane] = std::min<std::int64_t>(score[lane], limit + 1);
+        }
+    }
+#endif
+
+
+    DistancesFunction fastestDistances() noexcept
+    {
+#if LENGTHBUCKET_X86
+        if(__builtin_cpu_supports("avx2"))
+        {
+            return avx2Distances;
+        }
+#endif
+        return scalarDistances;
+    }
+
+
+    // rowDistance() is the distance for words too long to be a pattern,
+    // computed one row of the dynamic programming table at a time.
+    unsigned int rowDistance(const std::string& a, const char* b, std::size_t m, unsigned int limit)
+    {
+        std::size_t n = a.length();
+        std::vector<std::size_t> previous2(m + 1);
+        std::vector<std::size_t> previous(m + 1);
+        std::vector<std::size_t> current(m + 1);
+        for(std::size_t j = 0; j <= m; j++)
+        {
+            previous[j] = j;
+        }
+        for(std::size_t i = 1; i <= n; i++)
+        {
+            current[0] = i;
+            std::size_t rowMinimum = current[0];
+            for(std::size_t j = 1; j <= m; j++)
+            {
+                std::size_t cost = a[i - 1] == b[j - 1] ? 0 : 1;
+                current[j] = std::min({previous[j] + 1, current[j - 1] + 1, previous[j - 1] + cost});
+                if(i > 1 && j > 1 && a[i - 1] == b[j - 2] && a[i - 2] == b[j - 1])
+                {
+                    current[j] = std::min(current[j], previous2[j - 2] + 1);
+                }
+                rowMinimum = std::min(rowMinimum, current[j]);
+            }
+            if(rowMinimum > limit)
+            {
+                return limit + 1;
+            }
+            std::swap(previous2, previous);
+            std::swap(previous, current);
+        }
+        return std::min<std::size_t>(previous[m], limit + 1);
+    }
+}
+
+
+
+LengthBucketIndex::LengthBucketIndex()
+{
+}
+
+
+bool LengthBucketIndex::isImplemented() const noexcept
+{
+    return true;
+}
+
+
+void LengthBucketIndex::add(const std::string& element)
+{
+    if(!members.insert(element).second)
+    {
+        return;
+    }
+
+    if(element.length() >= buckets.size())
+    {
+        buckets.resize(element.length() + 1, Bucket{std::string{}, 0});
+    }
+    Bucket& bucket = buckets[element.length()];
+    bucket.letters.append(element);
+    bucket.count++;
+}
+
+
+bool LengthBucketIndex::contains(const std::string& element) const
+{
+    return members.count(element) != 0;
+}
+
+
+unsigned int LengthBucketIndex::size() const noexcept
+{
+    return members.size();
+}
+
+
+std::vector<std::string> LengthBucketIndex::findSuggestions(const std::string& word, unsigned int distance) const
+{
+    return findSuggestions(word, distance, CancellationToken::none());
+}
+
+
+std::vector<std::string> LengthBucketIndex::findSuggestions(
+    const std::string& word, unsigned int distance, const CancellationToken& token) const
+{
+    std::size_t shortest = word.length() > distance ? word.length() - distance : 0;
+    std::size_t longest = std::min<std::size_t>(word.length() + distance, buckets.size() - 1);
+
+    bool usePattern = !word.empty() && word.length() <= MAX_PATTERN_LENGTH;
+    Pattern pattern;
+    if(usePattern)
+    {
+        buildPattern(word, pattern);
+    }
+
+    static const DistancesFunction distancesOf = fastestDistances();
+
+    std::vector<std::pair<unsigned int, std::string_view>> verified;
+    auto verify = [&](const char* text, std::size_t n, unsigned int d)
+    {
+        if(d <= distance)
+        {
+            verified.emplace_back(d, std::string_view{text, n});
+        }
+    };
+
+    for(std::size_t n = shortest; n <= longest && n < buckets.size(); n++)
+    {
+        const Bucket& bucket = buckets[n];
+        const char* text = bucket.letters.data();
+        std::size_t i = 0;
+
+        if(!usePattern)
+        {
+            // The distance to the empty word is the other word's length.
+            for(; i < bucket.count; i++, text += n)
+            {
+                if(i % CANCELLATION_INTERVAL == 0)
+                {
+                    token.throwIfCancelled();
+                }
+                verify(text, n, word.empty() ? n : rowDistance(word, text, n, distance));
+            }
+            continue;
+        }
+
+        unsigned int distances[4];
+        for(; i + 4 <= bucket.count; i += 4, text += 4 * n)
+        {
+            if(i % CANCELLATION_INTERVAL == 0)
+            {
+                token.throwIfCancelled();
+            }
+            distancesOf(pattern, text, n, distance, distances);
+            for(int lane = 0; lane < 4; lane++)
+            {
+                verify(text + lane * n, n, distances[lane]);
+            }
+        }
+        for(; i < bucket.count; i++, text += n)
+        {
+            verify(text, n, bitParallelDistance(pattern, text, n, distance));
+        }
+    }
+
+    std::sort(verified.begin(), verified.end());
+
+    std::vector<std::string> result;
+    result.reserve(verified.size());
+    for(const auto& v : verified)
+    {
+        result.emplace_back(v.second);
+    }
+    return result;
+}
+
+
+std::size_t LengthBucketIndex::memoryUsage() const noexcept
+{
+    // The set's nodes each hold a string and a link; allocator overhead
+    // isn't included.
+    std::size_t bytes = sizeof(*this) + members.bucket_count() * sizeof(void*);
+    for(const std::string& word : members)
+    {
+        bytes += sizeof(void*) + sizeof(word);
+        if(word.capacity() > std::string{}.capacity())
+        {
+            bytes += word.capacity() + 1;
+        }
+    }
+    bytes += buckets.capacity() * sizeof(Bucket);
+    for(const Bucket& bucket : buckets)
+    {
+        bytes += bucket.letters.capacity();
+    }
+    return bytes;
+}
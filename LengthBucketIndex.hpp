@@ -0,0 +1,89 @@
+// LengthBucketIndex.hpp
+//
+// A LengthBucketIndex is an implementation of a Set of strings that also
+// keeps its words grouped by length, each group ("bucket") stored as one
+// contiguous run of characters, so that the words within a given edit
+// distance of a misspelling can be found by scanning, rather than by
+// generating and probing candidates.  Since a word of length n can only be
+// within distance d of a misspelling whose length is within d of n, only
+// the buckets for those lengths are scanned, and every word in them is
+// verified with a bit-parallel edit distance computation (Myers' algorithm,
+// as extended by Hyyro to count swaps of adjacent characters), which does
+// the work of a whole column of the usual dynamic programming table in a
+// handful of operations on one 64-bit word.  Where the processor supports
+// AVX2, words of the same length are verified four at a time, one in each
+// lane of a vector.
+//
+// Unlike a DeletionIndex, whose lookups are fast but whose memory grows
+// with the number of deletion variants, this costs a fixed amount per
+// word: each word is stored twice, once in a hash set that answers
+// contains() and once in its bucket, so it takes a little over twice the
+// memory of the words themselves.  Its lookups take a predictable time
+// that grows with the distance only by the number of buckets scanned.
+
+#ifndef LENGTHBUCKETINDEX_HPP
+#define LENGTHBUCKETINDEX_HPP
+
+#include <string>
+#include <unordered_set>
+#include <vector>
+#include "CancellationToken.hpp"
+#include "Set.hpp"
+
+
+
+class LengthBucketIndex : public Set<std::string>
+{
+public:
+    // Initializes an empty LengthBucketIndex.
+    LengthBucketIndex();
+
+
+    bool isImplemented() const noexcept override;
+
+
+    // add() adds a word to the set and to the bucket for its length.  If
+    // the word is already in the set, this function has no effect.
+    void add(const std::string& element) override;
+
+
+    // contains() returns true if the given word is in the set, false
+    // otherwise.
+    bool contains(const std::string& element) const override;
+
+
+    // size() returns the number of words in the set.
+    unsigned int size() const noexcept override;
+
+
+    // findSuggestions() returns the words within the given edit distance
+    // of the given word, counting insertions, deletions, replacements and
+    // swaps of adjacent characters as one edit each (as a DeletionIndex
+    // does).  The suggestions are ordered by distance, then alphabetically.
+    // Given a CancellationToken, it throws an OperationCancelled if the
+    // token is cancelled before it's done.
+    std::vector<std::string> findSuggestions(const std::string& word, unsigned int distance) const;
+    std::vector<std::string> findSuggestions(
+        const std::string& word, unsigned int distance, const CancellationToken& token) const;
+
+
+    // memoryUsage() returns an estimate, in bytes, of the memory used by
+    // the index.
+    std::size_t memoryUsage() const noexcept;
+
+
+private:
+    // A Bucket holds every word of one length, back to back.
+    struct Bucket
+    {
+        std::string letters;
+        std::size_t count;
+    };
+
+    std::unordered_set<std::string> members;
+    std::vector<Bucket> buckets;
+};
+
+
+
+#endif // LENGTHBUCKETINDEX_HPP
@@ -26,7 +26,11 @@
 
 #include <memory>
 #include <random>
+#include <string_view>
+#include <type_traits>
 #include "Set.hpp"
+#include "Stats.hpp"
+#include "StringLookup.hpp"
 
 
 
@@ -49,7 +53,9 @@ enum class SkipListKind
 // A SkipListKey represents a single key in a skip list.  It is possible
 // to compare these keys using < or == operators (which are overloaded here)
 // and those comparisons respect the notion of whether each key is normal,
-// -INF, or +INF.
+// -INF, or +INF.  A key can also be compared with an element, or anything
+// comparable with one (such as a std::string_view, for strings), by
+// holds() and follows(), so that a search needn't make a key to compare.
 
 template <typename ElementType>
 class SkipListKey
@@ -60,6 +66,13 @@ public:
     bool operator==(const SkipListKey& other) const;
     bool operator<(const SkipListKey& other) const;
 
+    // holds() returns true if this is a normal key equal to the element;
+    // follows() returns true if this key is greater than the element.
+    template <typename Key>
+    bool holds(const Key& element) const;
+    template <typename Key>
+    bool follows(const Key& element) const;
+
 private:
     SkipListKind kind;
     ElementType element;
@@ -98,6 +111,23 @@ bool SkipListKey<ElementType>::operator<(const SkipListKey& other) const
     }
 }
 
+
+template <typename ElementType>
+template <typename Key>
+bool SkipListKey<ElementType>::holds(const Key& element) const
+{
+    return kind == SkipListKind::Normal && this->element == element;
+}
+
+
+template <typename ElementType>
+template <typename Key>
+bool SkipListKey<ElementType>::follows(const Key& element) const
+{
+    return kind == SkipListKind::PosInf
+        || (kind == SkipListKind::Normal && element < this->element);
+}
+
 template <typename ElementType>
 struct Node
 {
@@ -173,7 +203,7 @@ std::unique_ptr<SkipListLevelTester<ElementType>> RandomSkipListLevelTester<Elem
 
 
 template <typename ElementType>
-class SkipListSet : public Set<ElementType>
+class SkipListSet : public Set<ElementType>, public StringLookupFor<SkipListSet<ElementType>, ElementType>
 {
 public:
     // Initializes an SkipListSet to be empty, with or without a
@@ -217,6 +247,11 @@ public:
     // with very high probability.
     bool contains(const ElementType& element) const override;
 
+    // A SkipListSet of strings can also be searched for a std::string_view,
+    // which is compared with the keys in place.
+    template <typename Key, typename = std::enable_if_t<impl_::StringLookup__isKey<ElementType, Key>>>
+    bool contains(const Key& element) const;
+
 
     // size() returns the number of elements in the set.
     unsigned int size() const noexcept override;
@@ -249,6 +284,9 @@ private:
     Node<ElementType>* tail;
     Node<ElementType>* topHead;
     Node<ElementType>* topTail;
+
+    template <typename Key>
+    bool containsHelper(const Key& element) const;
 };
 
 
@@ -603,15 +641,36 @@ void SkipListSet<ElementType>::add(const ElementType& element)
 template <typename ElementType>
 bool SkipListSet<ElementType>::contains(const ElementType& element) const
 {
+    return containsHelper(element);
+}
+
+
+template <typename ElementType>
+template <typename Key, typename>
+bool SkipListSet<ElementType>::contains(const Key& element) const
+{
+    return containsHelper(std::string_view{element});
+}
+
+
+template <typename ElementType>
+template <typename Key>
+bool SkipListSet<ElementType>::containsHelper(const Key& element) const
+{
+    // The element is compared with the keys directly, rather than being
+    // copied into a key of its own.
     Node<ElementType>* current = topHead;
-    SkipListKey s{SkipListKind::Normal, element};
+    unsigned int visited = 0;
+    bool found = false;
     while(true)
     {
-        if (current->key == s)
+        visited++;
+        if (current->key.holds(element))
         {
-            return true;
+            found = true;
+            break;
         }
-        else if (s < current->right->key)
+        else if (current->right->key.follows(element))
         {
             if(current->bottom == nullptr)
             {
@@ -624,7 +683,9 @@ bool SkipListSet<ElementType>::contains(const ElementType& element) const
             current = current->right;
         }
     }
-    return false;
+    SPELLCHECK_COUNT(skipListSetContains, 1);
+    SPELLCHECK_COUNT(skipListSetNodes, visited);
+    return found;
 }
 
 
@@ -0,0 +1,202 @@
+// SpellClient.cpp
+
+#include "SpellClient.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#include <string_view>
+#include <system_error>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include "SpellProtocol.hpp"
+
+
+
+namespace
+{
+    [[noreturn]] void throwSystemError(const std::string& what)
+    {
+        throw std::system_error{errno, std::generic_category(), what};
+    }
+
+
+    std::vector<std::string> splitLines(std::string_view text)
+    {
+        std::vector<std::string> lines;
+        while(!text.empty())
+        {
+            std::size_t end = text.find('\n');
+            lines.emplace_back(text.substr(0, end));
+            text.remove_prefix(end == std::string_view::npos ? text.length() : end + 1);
+        }
+        return lines;
+    }
+}
+
+
+
+SpellClient::SpellClient(const std::string& socketPath)
+    : fd{-1}, nextId{0}
+{
+    sockaddr_un address{};
+    address.sun_family = AF_UNIX;
+    if(socketPath.empty() || socketPath.length() >= sizeof(address.sun_path))
+    {
+        throw std::system_error{ENAMETOOLONG, std::generic_category(), "bad socket path " + socketPath};
+    }
+    std::memcpy(address.sun_path, socketPath.c_str(), socketPath.length() + 1);
+
+    fd = ::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if(fd < 0)
+    {
+        throwSystemError("cannot create socket");
+    }
+    if(::connect(fd, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) < 0)
+    {
+        int error = errno;
+        ::close(fd);
+        throw std::system_error{error, std::generic_category(), "cannot connect to " + socketPath};
+    }
+}
+
+
+SpellClient::~SpellClient() noexcept
+{
+    ::close(fd);
+}
+
+
+bool SpellClient::wordExists(const std::string& word)
+{
+    return wordsExist({word})[0];
+}
+
+
+std::vector<std::string> SpellClient::findSuggestions(const std::string& word)
+{
+    return std::move(findSuggestions(std::vector<std::string>{word})[0]);
+}
+
+
+std::vector<bool> SpellClient::wordsExist(const std::vector<std::string>& words)
+{
+    std::vector<std::string> bodies = request(SPELL_WORD_EXISTS, words);
+    std::vector<bool> exists(bodies.size());
+    for(std::size_t i = 0; i < bodies.size(); i++)
+    {
+        exists[i] = bodies[i] == "1";
+    }
+    return exists;
+}
+
+
+std::vector<std::vector<std::string>> SpellClient::findSuggestions(const std::vector<std::string>& words)
+{
+    std::vector<std::string> bodies = request(SPELL_FIND_SUGGESTIONS, words);
+    std::vector<std::vector<std::string>> suggestions;
+    suggestions.reserve(bodies.size());
+    for(const std::string& body : bodies)
+    {
+        suggestions.push_back(splitLines(body));
+    }
+    return suggestions;
+}
+
+
+std::vector<std::string> SpellClient::request(char code, const std::vector<std::string>& words)
+{
+    // The ids of this batch run from firstId, so a response's id says which
+    // word it answers.
+    std::uint32_t firstId = nextId;
+    nextId += words.size();
+
+    std::string output;
+    for(std::size_t i = 0; i < words.size(); i++)
+    {
+        appendSpellMessage(output, firstId + std::uint32_t(i), code, words[i]);
+    }
+    std::string_view unsent{output};
+
+    // Responses are read while the batch is still being sent: the server
+    // answers requests as they arrive, and if nothing read its answers, it
+    // would block sending them (and give up on this client) while this
+    // blocked sending it more requests.
+    std::vector<std::string> bodies(words.size());
+    bool failed = false;
+    std::size_t consumed = 0;
+    char chunk[16 * 1024];
+    for(std::size_t answered = 0; answered < words.size(); )
+    {
+        SpellMessage message;
+        std::size_t size;
+        SpellParse parsed = parseSpellMessage(std::string_view{input}.substr(consumed), message, size);
+        if(parsed == SpellParse::Complete)
+        {
+            std::uint32_t index = message.id - firstId;
+            if(index < words.size())
+            {
+                bodies[index] = message.body;
+                failed = failed || message.code != SPELL_OK;
+                answered++;
+            }
+            consumed += size;
+            continue;
+        }
+        else if(parsed == SpellParse::Malformed)
+        {
+            throw std::runtime_error{"malformed response from spell server"};
+        }
+        input.erase(0, consumed);
+        consumed = 0;
+
+        pollfd polled{fd, short(unsent.empty() ? POLLIN : POLLIN | POLLOUT), 0};
+        if(::poll(&polled, 1, -1) < 0)
+        {
+            if(errno == EINTR)
+            {
+                continue;
+            }
+            throwSystemError("cannot poll");
+        }
+
+        if(polled.revents & POLLOUT)
+        {
+            ssize_t sent = ::send(fd, unsent.data(), unsent.length(), MSG_NOSIGNAL | MSG_DONTWAIT);
+            if(sent < 0 && errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR)
+            {
+                throwSystemError("cannot send request");
+            }
+            unsent.remove_prefix(std::max<ssize_t>(sent, 0));
+        }
+
+        if(polled.revents & (POLLIN | POLLHUP | POLLERR))
+        {
+            ssize_t received = ::recv(fd, chunk, sizeof(chunk), MSG_DONTWAIT);
+            if(received < 0 && (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR))
+            {
+                continue;
+            }
+            if(received < 0)
+            {
+                throwSystemError("cannot receive response");
+            }
+            if(received == 0)
+            {
+                throw std::runtime_error{"spell server closed the connection"};
+            }
+            input.append(chunk, received);
+        }
+    }
+    input.erase(0, consumed);
+
+    // Every response is read, even after a failure, so that the next batch
+    // doesn't see this one's.
+    if(failed)
+    {
+        throw std::runtime_error{"spell server failed to answer"};
+    }
+    return bodies;
+}
@@ -0,0 +1,58 @@
+// SpellClient.hpp
+//
+// A SpellClient asks a SpellServer, over its Unix domain socket, whether
+// words exist and what to suggest for them.  The batch versions send every
+// request without waiting for the responses, which are read as they come
+// back while the rest are still being sent, so that the whole batch costs
+// about one round trip, and the server can answer many of its requests
+// together.
+//
+// Like a WordChecker, a SpellClient expects words in the form its server's
+// dictionary holds them (e.g., uppercase).  A SpellClient isn't safe to
+// share between threads; give each thread its own.
+
+#ifndef SPELLCLIENT_HPP
+#define SPELLCLIENT_HPP
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+
+
+class SpellClient
+{
+public:
+    // Initializes a SpellClient connected to the server listening at the
+    // given path.  Throws a std::system_error if it can't connect.
+    explicit SpellClient(const std::string& socketPath);
+
+    ~SpellClient() noexcept;
+
+    SpellClient(const SpellClient& c) = delete;
+    SpellClient& operator=(const SpellClient& c) = delete;
+
+
+    // These mirror WordChecker's wordExists() and findSuggestions().  They
+    // throw a std::system_error if the connection fails, or a
+    // std::runtime_error if the server can't answer.
+    bool wordExists(const std::string& word);
+    std::vector<std::string> findSuggestions(const std::string& word);
+
+    std::vector<bool> wordsExist(const std::vector<std::string>& words);
+    std::vector<std::vector<std::string>> findSuggestions(const std::vector<std::string>& words);
+
+
+private:
+    int fd;
+    std::uint32_t nextId;
+    std::string input;
+
+    // request() sends one request per word, with the given code, and
+    // returns the bodies of the responses, in the words' order.
+    std::vector<std::string> request(char code, const std::vector<std::string>& words);
+};
+
+
+
+#endif // SPELLCLIENT_HPP
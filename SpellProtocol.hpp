@@ -0,0 +1,114 @@
+// SpellProtocol.hpp
+//
+// The messages that a SpellServer and its clients (such as a SpellClient)
+// exchange over a Unix domain socket.  Each message is framed as:
+//
+//     length   4 bytes, big-endian: the number of bytes that follow
+//     id       4 bytes, big-endian: chosen by the client
+//     code     1 byte
+//     body     length - 5 bytes
+//
+// A request's code is SPELL_WORD_EXISTS or SPELL_FIND_SUGGESTIONS, and its
+// body is the word.  The server answers every request with a response
+// carrying the same id, so that a client can send many requests before
+// reading any responses; responses may arrive in any order.  A response's
+// code is SPELL_OK or SPELL_FAILED, and a successful response's body is
+// "1" or "0" (whether the word exists) or the suggestions, separated by
+// newlines.  A message longer than SPELL_MAX_MESSAGE is malformed, so a
+// body can be at most SPELL_MAX_BODY bytes; suggestions that wouldn't fit
+// are left off the end of the list.
+
+#ifndef SPELLPROTOCOL_HPP
+#define SPELLPROTOCOL_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+
+
+constexpr char SPELL_WORD_EXISTS = 'E';
+constexpr char SPELL_FIND_SUGGESTIONS = 'S';
+constexpr char SPELL_OK = 0;
+constexpr char SPELL_FAILED = 1;
+
+constexpr std::size_t SPELL_HEADER_SIZE = 9;
+constexpr std::size_t SPELL_MAX_MESSAGE = 64 * 1024;
+constexpr std::size_t SPELL_MAX_BODY = SPELL_MAX_MESSAGE - (SPELL_HEADER_SIZE - 4);
+
+
+// A SpellMessage is one decoded request or response; its body refers to
+// the buffer it was decoded from.
+struct SpellMessage
+{
+    std::uint32_t id;
+    char code;
+    std::string_view body;
+};
+
+
+enum class SpellParse
+{
+    Complete,
+    Incomplete,
+    Malformed
+};
+
+
+
+// appendSpellMessage() appends the framed message to "out".
+inline void appendSpellMessage(std::string& out, std::uint32_t id, char code, std::string_view body)
+{
+    auto appendWord = [&out](std::uint32_t value)
+    {
+        for(int shift = 24; shift >= 0; shift -= 8)
+        {
+            out.push_back(char((value >> shift) & 0xff));
+        }
+    };
+    appendWord(std::uint32_t(body.length() + SPELL_HEADER_SIZE - 4));
+    appendWord(id);
+    out.push_back(code);
+    out.append(body);
+}
+
+
+// parseSpellMessage() decodes the message at the start of "buffer",
+// setting "size" to the number of bytes it takes up, unless the buffer
+// doesn't hold all of it yet.
+inline SpellParse parseSpellMessage(std::string_view buffer, SpellMessage& message, std::size_t& size)
+{
+    auto wordAt = [buffer](std::size_t i)
+    {
+        std::uint32_t value = 0;
+        for(std::size_t b = i; b < i + 4; b++)
+        {
+            value = (value << 8) | static_cast<unsigned char>(buffer[b]);
+        }
+        return value;
+    };
+
+    if(buffer.length() < 4)
+    {
+        return SpellParse::Incomplete;
+    }
+    std::size_t length = wordAt(0);
+    if(length < SPELL_HEADER_SIZE - 4 || length > SPELL_MAX_MESSAGE)
+    {
+        return SpellParse::Malformed;
+    }
+    if(buffer.length() < length + 4)
+    {
+        return SpellParse::Incomplete;
+    }
+    message.id = wordAt(4);
+    message.code = buffer[8];
+    message.body = buffer.substr(SPELL_HEADER_SIZE, length + 4 - SPELL_HEADER_SIZE);
+    size = length + 4;
+    return SpellParse::Complete;
+}
+
+
+
+#endif // SPELLPROTOCOL_HPP
@@ -0,0 +1,395 @@
+// SpellServer.cpp
+
+#include "SpellServer.hpp"
+#include <cerrno>
+#include <cstring>
+#include <mutex>
+#include <string_view>
+#include <system_error>
+#include <utility>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include "SpellProtocol.hpp"
+
+
+
+namespace
+{
+    // A worker gives up on a client that hasn't read its responses for this
+    // long, rather than waiting on it forever.
+    constexpr int SEND_TIMEOUT_SECONDS = 5;
+
+    constexpr std::size_t READ_SIZE = 64 * 1024;
+
+
+    [[noreturn]] void throwSystemError(const std::string& what)
+    {
+        throw std::system_error{errno, std::generic_category(), what};
+    }
+
+
+    void closeIfOpen(int fd) noexcept
+    {
+        if(fd >= 0)
+        {
+            ::close(fd);
+        }
+    }
+
+
+    bool sendAll(int fd, std::string_view data)
+    {
+        while(!data.empty())
+        {
+            ssize_t sent = ::send(fd, data.data(), data.length(), MSG_NOSIGNAL);
+            if(sent < 0)
+            {
+                if(errno == EINTR)
+                {
+                    continue;
+                }
+                return false;
+            }
+            data.remove_prefix(sent);
+        }
+        return true;
+    }
+}
+
+
+
+// A Connection closes its socket once neither run() nor any batch still
+// waiting to be answered needs it.
+struct SpellServer::Connection
+{
+    int fd;
+    std::mutex writing;
+
+    explicit Connection(int fd)
+        : fd{fd}
+    {
+    }
+
+    ~Connection() noexcept
+    {
+        ::close(fd);
+    }
+};
+
+
+
+SpellServer::SpellServer(const WordChecker& checker, const std::string& socketPath)
+    : SpellServer{checker, socketPath, Options{}}
+{
+}
+
+
+SpellServer::SpellServer(const WordChecker& checker, const std::string& socketPath, const Options& options)
+    : checker{checker}, socketPath{socketPath}, options{options},
+      listener{-1}, wakeRead{-1}, wakeWrite{-1}, workers{options.threadCount}
+{
+    sockaddr_un address{};
+    address.sun_family = AF_UNIX;
+    if(socketPath.empty() || socketPath.length() >= sizeof(address.sun_path))
+    {
+        throw std::system_error{ENAMETOOLONG, std::generic_category(), "bad socket path " + socketPath};
+    }
+    std::memcpy(address.sun_path, socketPath.c_str(), socketPath.length() + 1);
+
+    try
+    {
+        // stop() wakes run() by writing to this pipe.
+        int ends[2];
+        if(::pipe2(ends, O_CLOEXEC | O_NONBLOCK) < 0)
+        {
+            throwSystemError("cannot create pipe");
+        }
+        wakeRead = ends[0];
+        wakeWrite = ends[1];
+
+        listener = ::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        if(listener < 0)
+        {
+            throwSystemError("cannot create socket");
+        }
+
+        // Only a socket (left behind by an earlier server) is replaced.
+        struct stat existing;
+        if(::lstat(socketPath.c_str(), &existing) == 0 && S_ISSOCK(existing.st_mode))
+        {
+            ::unlink(socketPath.c_str());
+        }
+        if(::bind(listener, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) < 0)
+        {
+            throwSystemError("cannot bind " + socketPath);
+        }
+        if(::listen(listener, SOMAXCONN) < 0)
+        {
+            ::unlink(socketPath.c_str());
+            throwSystemError("cannot listen on " + socketPath);
+        }
+    }
+    catch(...)
+    {
+        closeIfOpen(listener);
+        closeIfOpen(wakeRead);
+        closeIfOpen(wakeWrite);
+        throw;
+    }
+
+    batch.reserve(options.maxBatchSize);
+}
+
+
+SpellServer::~SpellServer() noexcept
+{
+    // The workers, destroyed after this, finish the batches they were given.
+    ::close(listener);
+    ::unlink(socketPath.c_str());
+    ::close(wakeRead);
+    ::close(wakeWrite);
+}
+
+
+void SpellServer::run()
+{
+    // A Client is a connection as run() sees it, along with the bytes read
+    // from it that don't yet make up a whole request.
+    struct Client
+    {
+        std::shared_ptr<Connection> connection;
+        std::string input;
+        bool open;
+    };
+
+    std::vector<Client> clients;
+    std::vector<pollfd> polled;
+    std::vector<char> chunk(READ_SIZE);
+
+    // read() reads what the client has sent, gathering the requests in it,
+    // and returns false if the client should be dropped.
+    auto read = [&](Client& client)
+    {
+        ssize_t received = ::recv(client.connection->fd, chunk.data(), chunk.size(), MSG_DONTWAIT);
+        if(received <= 0)
+        {
+            return received < 0 && (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR);
+        }
+        client.input.append(chunk.data(), received);
+
+        std::string_view input{client.input};
+        SpellMessage message;
+        std::size_t size;
+        SpellParse parsed;
+        while((parsed = parseSpellMessage(input, message, size)) == SpellParse::Complete)
+        {
+            if(batch.empty())
+            {
+                batchStart = std::chrono::steady_clock::now();
+            }
+            batch.push_back(Request{client.connection, message.id, message.code, std::string{message.body}});
+            if(batch.size() >= options.maxBatchSize)
+            {
+                dispatch();
+            }
+            input.remove_prefix(size);
+        }
+        client.input.erase(0, client.input.length() - input.length());
+        return parsed != SpellParse::Malformed;
+    };
+
+    bool stopping = false;
+    while(!stopping)
+    {
+        polled.clear();
+        polled.push_back(pollfd{wakeRead, POLLIN, 0});
+        polled.push_back(pollfd{listener, POLLIN, 0});
+        for(const Client& client : clients)
+        {
+            polled.push_back(pollfd{client.connection->fd, POLLIN, 0});
+        }
+
+        // Waiting is cut short when the batch's oldest request is due.
+        timespec timeout{};
+        timespec* waitFor = nullptr;
+        if(!batch.empty())
+        {
+            auto left = batchStart + options.maxBatchDelay - std::chrono::steady_clock::now();
+            if(left <= left.zero())
+            {
+                dispatch();
+                continue;
+            }
+            auto nanoseconds = std::chrono::duration_cast<std::chrono::nanoseconds>(left).count();
+            timeout.tv_sec = nanoseconds / 1000000000;
+            timeout.tv_nsec = nanoseconds % 1000000000;
+            waitFor = &timeout;
+        }
+
+        if(::ppoll(polled.data(), polled.size(), waitFor, nullptr) < 0)
+        {
+            if(errno == EINTR)
+            {
+                continue;
+            }
+            throwSystemError("cannot poll");
+        }
+
+        if(polled[0].revents != 0)
+        {
+            char drained[64];
+            while(::read(wakeRead, drained, sizeof(drained)) > 0)
+            {
+            }
+            stopping = true;
+        }
+
+        for(std::size_t c = 0; c < clients.size(); c++)
+        {
+            if(polled[c + 2].revents != 0)
+            {
+                clients[c].open = read(clients[c]);
+            }
+        }
+        for(std::size_t c = 0; c < clients.size(); )
+        {
+            if(clients[c].open)
+            {
+                c++;
+            }
+            else
+            {
+                clients[c] = std::move(clients.back());
+                clients.pop_back();
+            }
+        }
+
+        if(polled[1].revents & POLLIN)
+        {
+            int fd = ::accept4(listener, nullptr, nullptr, SOCK_CLOEXEC);
+            if(fd >= 0)
+            {
+                timeval sendTimeout{SEND_TIMEOUT_SECONDS, 0};
+                ::setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &sendTimeout, sizeof(sendTimeout));
+                clients.push_back(Client{std::make_shared<Connection>(fd), std::string{}, true});
+            }
+        }
+    }
+
+    if(!batch.empty())
+    {
+        dispatch();
+    }
+}
+
+
+void SpellServer::stop() noexcept
+{
+    // Only write() is used here, since it's safe in a signal handler.
+    char wake = 0;
+    [[maybe_unused]] ssize_t written = ::write(wakeWrite, &wake, 1);
+}
+
+
+void SpellServer::dispatch()
+{
+    workers.submit([this, requests = std::move(batch)]() { answer(requests); });
+    batch.clear();
+    batch.reserve(options.maxBatchSize);
+}
+
+
+void SpellServer::answer(const std::vector<Request>& requests) const
+{
+    // Each kind of request is answered by one call to the WordChecker.
+    std::vector<std::string_view> lookups;
+    std::vector<std::string_view> misspellings;
+    for(const Request& request : requests)
+    {
+        if(request.code == SPELL_WORD_EXISTS)
+        {
+            lookups.push_back(request.word);
+        }
+        else if(request.code == SPELL_FIND_SUGGESTIONS)
+        {
+            misspellings.push_back(request.word);
+        }
+    }
+
+    std::vector<bool> misspelled;
+    std::vector<std::vector<std::string>> suggestions;
+    bool failed = false;
+    try
+    {
+        misspelled = checker.checkWords(lookups);
+        suggestions = checker.findSuggestions(misspellings, std::vector<bool>(misspellings.size(), true));
+    }
+    catch(const std::exception&)
+    {
+        failed = true;
+    }
+
+    // The responses to each connection are written all at once.
+    std::vector<std::pair<Connection*, std::string>> outputs;
+    std::string body;
+    std::size_t lookup = 0;
+    std::size_t misspelling = 0;
+    for(const Request& request : requests)
+    {
+        char code = failed ? SPELL_FAILED : SPELL_OK;
+        body.clear();
+        if(request.code == SPELL_WORD_EXISTS)
+        {
+            if(!failed)
+            {
+                body = misspelled[lookup] ? "0" : "1";
+            }
+            lookup++;
+        }
+        else if(request.code == SPELL_FIND_SUGGESTIONS)
+        {
+            if(!failed)
+            {
+                // Suggestions that don't fit in a message are left off.
+                for(const std::string& suggestion : suggestions[misspelling])
+                {
+                    if(body.length() + (body.empty() ? 0 : 1) + suggestion.length() > SPELL_MAX_BODY)
+                    {
+                        break;
+                    }
+                    body.append(body.empty() ? "" : "\n").append(suggestion);
+                }
+            }
+            misspelling++;
+        }
+        else
+        {
+            code = SPELL_FAILED;
+        }
+
+        std::size_t o = 0;
+        while(o < outputs.size() && outputs[o].first != request.connection.get())
+        {
+            o++;
+        }
+        if(o == outputs.size())
+        {
+            outputs.emplace_back(request.connection.get(), std::string{});
+        }
+        appendSpellMessage(outputs[o].second, request.id, code, body);
+    }
+
+    for(const auto& output : outputs)
+    {
+        std::lock_guard<std::mutex> lock{output.first->writing};
+        if(!sendAll(output.first->fd, output.second))
+        {
+            // run() sees the connection close and drops it.
+            ::shutdown(output.first->fd, SHUT_RDWR);
+        }
+    }
+}
@@ -0,0 +1,104 @@
+// SpellServer.hpp
+//
+// A SpellServer answers wordExists() and findSuggestions() requests (see
+// SpellProtocol.hpp) from any number of clients connected to a Unix domain
+// socket, all from one WordChecker, so that a dictionary is loaded once per
+// process rather than once per client.
+//
+// One thread (the one that calls run()) accepts connections and reads
+// requests from all of them.  Rather than being answered one at a time,
+// the requests are gathered, across clients, into micro-batches: a batch
+// is handed to the server's worker threads when it holds maxBatchSize
+// requests, or when its oldest request has waited maxBatchDelay, whichever
+// comes first.  A worker answers a whole batch with WordChecker's batch
+// versions of checkWords() and findSuggestions(), which look up a word
+// that several clients asked about only once.
+//
+// The workers are the server's own ThreadPool, distinct from any pool the
+// WordChecker uses for parallel suggestions, since a worker that waited
+// for tasks queued behind its own batch would never finish.
+
+#ifndef SPELLSERVER_HPP
+#define SPELLSERVER_HPP
+
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+#include "ThreadPool.hpp"
+#include "WordChecker.hpp"
+
+
+
+class SpellServer
+{
+public:
+    struct Options
+    {
+        std::size_t maxBatchSize = 32;
+        std::chrono::microseconds maxBatchDelay{100};
+        unsigned int threadCount = std::thread::hardware_concurrency();
+    };
+
+
+    // Initializes a SpellServer that answers from the given checker, which
+    // must outlive it, listening on a new socket at the given path (an
+    // existing socket there is replaced).  Throws a std::system_error if
+    // the socket can't be created.
+    SpellServer(const WordChecker& checker, const std::string& socketPath);
+    SpellServer(const WordChecker& checker, const std::string& socketPath, const Options& options);
+
+    // Closes the socket and removes it, after the workers have answered
+    // every batch already handed to them.
+    ~SpellServer() noexcept;
+
+    SpellServer(const SpellServer& s) = delete;
+    SpellServer& operator=(const SpellServer& s) = delete;
+
+
+    // run() accepts connections and serves requests until stop() is called,
+    // then hands the requests it has gathered to the workers and returns,
+    // closing the connections once they've been answered.
+    void run();
+
+
+    // stop() makes run() return.  It can be called from any thread, or from
+    // a signal handler, before or during run().
+    void stop() noexcept;
+
+
+private:
+    struct Connection;
+
+    struct Request
+    {
+        std::shared_ptr<Connection> connection;
+        std::uint32_t id;
+        char code;
+        std::string word;
+    };
+
+    const WordChecker& checker;
+    std::string socketPath;
+    Options options;
+    int listener;
+    int wakeRead;
+    int wakeWrite;
+    ThreadPool workers;
+
+    std::vector<Request> batch;
+    std::chrono::steady_clock::time_point batchStart;
+
+    // dispatch() hands the gathered requests to a worker.
+    void dispatch();
+
+    // answer() answers a batch of requests, writing the responses to each
+    // connection at once.
+    void answer(const std::vector<Request>& requests) const;
+};
+
+
+
+#endif // SPELLSERVER_HPP
@@ -0,0 +1,125 @@
+// Stats.cpp
+
+#include "Stats.hpp"
+#include <sstream>
+
+
+
+namespace
+{
+    const char* const STRATEGY_NAMES[SUGGESTION_STRATEGY_COUNT] = {
+        "swap", "insert", "delete", "replace", "split"
+    };
+
+
+    std::uint64_t load(const std::atomic<std::uint64_t>& counter) noexcept
+    {
+        return counter.load(std::memory_order_relaxed);
+    }
+
+
+    void writeHeader(std::ostream& out, const char* name, const char* help)
+    {
+        out << "# HELP " << name << ' ' << help << '\n'
+            << "# TYPE " << name << " counter\n";
+    }
+
+
+    template <typename Value>
+    void writeCounter(std::ostream& out, const char* name, const char* help, Value value)
+    {
+        writeHeader(out, name, help);
+        out << name << ' ' << value << '\n';
+    }
+
+
+    void writeByStrategy(std::ostream& out, const char* name, const char* help,
+                         const std::uint64_t (&values)[SUGGESTION_STRATEGY_COUNT])
+    {
+        writeHeader(out, name, help);
+        for(std::size_t s = 0; s < SUGGESTION_STRATEGY_COUNT; s++)
+        {
+            out << name << "{strategy=\"" << STRATEGY_NAMES[s] << "\"} " << values[s] << '\n';
+        }
+    }
+}
+
+
+
+StatsSnapshot statsSnapshot() noexcept
+{
+    StatsSnapshot snapshot;
+    for(std::size_t s = 0; s < SUGGESTION_STRATEGY_COUNT; s++)
+    {
+        snapshot.suggestionProbes[s] = load(statsCounters.suggestionProbes[s]);
+        snapshot.suggestionHits[s] = load(statsCounters.suggestionHits[s]);
+    }
+    snapshot.hashSetContains = load(statsCounters.hashSetContains);
+    snapshot.hashSetChainNodes = load(statsCounters.hashSetChainNodes);
+    snapshot.hashSetResizes = load(statsCounters.hashSetResizes);
+    snapshot.hashSetResizeNanoseconds = load(statsCounters.hashSetResizeNanoseconds);
+    snapshot.flatHashSetContains = load(statsCounters.flatHashSetContains);
+    snapshot.flatHashSetGroups = load(statsCounters.flatHashSetGroups);
+    snapshot.flatHashSetResizes = load(statsCounters.flatHashSetResizes);
+    snapshot.avlSetContains = load(statsCounters.avlSetContains);
+    snapshot.avlSetNodes = load(statsCounters.avlSetNodes);
+    snapshot.skipListSetContains = load(statsCounters.skipListSetContains);
+    snapshot.skipListSetNodes = load(statsCounters.skipListSetNodes);
+    return snapshot;
+}
+
+
+void resetStats() noexcept
+{
+    for(std::size_t s = 0; s < SUGGESTION_STRATEGY_COUNT; s++)
+    {
+        statsCounters.suggestionProbes[s].store(0, std::memory_order_relaxed);
+        statsCounters.suggestionHits[s].store(0, std::memory_order_relaxed);
+    }
+    statsCounters.hashSetContains.store(0, std::memory_order_relaxed);
+    statsCounters.hashSetChainNodes.store(0, std::memory_order_relaxed);
+    statsCounters.hashSetResizes.store(0, std::memory_order_relaxed);
+    statsCounters.hashSetResizeNanoseconds.store(0, std::memory_order_relaxed);
+    statsCounters.flatHashSetContains.store(0, std::memory_order_relaxed);
+    statsCounters.flatHashSetGroups.store(0, std::memory_order_relaxed);
+    statsCounters.flatHashSetResizes.store(0, std::memory_order_relaxed);
+    statsCounters.avlSetContains.store(0, std::memory_order_relaxed);
+    statsCounters.avlSetNodes.store(0, std::memory_order_relaxed);
+    statsCounters.skipListSetContains.store(0, std::memory_order_relaxed);
+    statsCounters.skipListSetNodes.store(0, std::memory_order_relaxed);
+}
+
+
+std::string prometheusText(const StatsSnapshot& snapshot)
+{
+    // Averages (chain length, nodes per lookup, hit rate) are left to the
+    // monitoring system, which divides one counter's rate by another's.
+    std::ostringstream out;
+    writeByStrategy(out, "spellcheck_suggestion_probes_total",
+                    "Candidates looked up by each suggestion strategy.", snapshot.suggestionProbes);
+    writeByStrategy(out, "spellcheck_suggestion_hits_total",
+                    "Candidates found to be words by each suggestion strategy.", snapshot.suggestionHits);
+    writeCounter(out, "spellcheck_hashset_contains_total",
+                 "Calls to HashSet::contains().", snapshot.hashSetContains);
+    writeCounter(out, "spellcheck_hashset_chain_nodes_total",
+                 "Chain nodes walked by HashSet::contains().", snapshot.hashSetChainNodes);
+    writeCounter(out, "spellcheck_hashset_resizes_total",
+                 "Resizes of a HashSet's array.", snapshot.hashSetResizes);
+    writeCounter(out, "spellcheck_hashset_resize_seconds_total",
+                 "Time spent resizing HashSets' arrays.", snapshot.hashSetResizeNanoseconds / 1e9);
+    writeCounter(out, "spellcheck_flathashset_contains_total",
+                 "Lookups in FlatHashSets, by add() or contains().", snapshot.flatHashSetContains);
+    writeCounter(out, "spellcheck_flathashset_groups_total",
+                 "Groups of control bytes examined by FlatHashSet lookups.", snapshot.flatHashSetGroups);
+    writeCounter(out, "spellcheck_flathashset_resizes_total",
+                 "Growths of a FlatHashSet's table.", snapshot.flatHashSetResizes);
+    writeCounter(out, "spellcheck_avlset_contains_total",
+                 "Calls to AVLSet::contains().", snapshot.avlSetContains);
+    writeCounter(out, "spellcheck_avlset_nodes_total",
+                 "Nodes visited by AVLSet::contains().", snapshot.avlSetNodes);
+    writeCounter(out, "spellcheck_skiplistset_contains_total",
+                 "Calls to SkipListSet::contains().", snapshot.skipListSetContains);
+    writeCounter(out, "spellcheck_skiplistset_nodes_total",
+                 "Nodes visited by SkipListSet::contains().", snapshot.skipListSetNodes);
+    return out.str();
+}
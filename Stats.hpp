@@ -0,0 +1,162 @@
+// Stats.hpp
+//
+// Optional counters on the hot paths of WordChecker and the Set
+// implementations, for finding out why a spell checker is slow without
+// attaching a profiler:
+//
+//   * how many candidates each of WordChecker's suggestion strategies
+//     probes, and how many of those probes find a word
+//   * how many nodes HashSet::contains() walks along its chains
+//   * how many groups of control bytes FlatHashSet::contains() examines
+//   * how many nodes AVLSet::contains() and SkipListSet::contains() visit
+//   * how often HashSet::add() resizes its array, and how long that takes,
+//     and how often FlatHashSet::add() grows its table
+//
+// The counters are only kept when the program is compiled with
+// SPELLCHECK_STATS defined as 1 (e.g., -DSPELLCHECK_STATS=1), in every
+// translation unit alike.  Otherwise, the SPELLCHECK_COUNT and
+// SPELLCHECK_TIME macros that the hot paths use expand to nothing, so
+// they cost nothing.  The counters are atomic, updated with relaxed
+// ordering, so they can be shared by many threads.
+//
+// statsSnapshot() copies the counters into a StatsSnapshot, and
+// prometheusText() formats one in the Prometheus text exposition format.
+
+#ifndef STATS_HPP
+#define STATS_HPP
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+#ifndef SPELLCHECK_STATS
+#define SPELLCHECK_STATS 0
+#endif
+
+
+
+// SuggestionStrategy names WordChecker's ways of generating suggestions.
+enum class SuggestionStrategy
+{
+    Swap,
+    Insert,
+    Delete,
+    Replace,
+    Split
+};
+
+constexpr std::size_t SUGGESTION_STRATEGY_COUNT = 5;
+
+
+
+// A StatsSnapshot holds the values of all of the counters at one time.
+// (When findSuggestions()'s swaps, insertions, deletions and replacements
+// walk a TrieSet instead of probing it, only their hits are counted; the
+// splits, and findLikelySuggestions()'s walks, also count the probes that
+// they stand in for.)
+struct StatsSnapshot
+{
+    std::uint64_t suggestionProbes[SUGGESTION_STRATEGY_COUNT];
+    std::uint64_t suggestionHits[SUGGESTION_STRATEGY_COUNT];
+    std::uint64_t hashSetContains;
+    std::uint64_t hashSetChainNodes;
+    std::uint64_t hashSetResizes;
+    std::uint64_t hashSetResizeNanoseconds;
+    std::uint64_t flatHashSetContains;
+    std::uint64_t flatHashSetGroups;
+    std::uint64_t flatHashSetResizes;
+    std::uint64_t avlSetContains;
+    std::uint64_t avlSetNodes;
+    std::uint64_t skipListSetContains;
+    std::uint64_t skipListSetNodes;
+};
+
+
+// StatsCounters are the live counters behind a StatsSnapshot.
+struct StatsCounters
+{
+    std::atomic<std::uint64_t> suggestionProbes[SUGGESTION_STRATEGY_COUNT];
+    std::atomic<std::uint64_t> suggestionHits[SUGGESTION_STRATEGY_COUNT];
+    std::atomic<std::uint64_t> hashSetContains;
+    std::atomic<std::uint64_t> hashSetChainNodes;
+    std::atomic<std::uint64_t> hashSetResizes;
+    std::atomic<std::uint64_t> hashSetResizeNanoseconds;
+    std::atomic<std::uint64_t> flatHashSetContains;
+    std::atomic<std::uint64_t> flatHashSetGroups;
+    std::atomic<std::uint64_t> flatHashSetResizes;
+    std::atomic<std::uint64_t> avlSetContains;
+    std::atomic<std::uint64_t> avlSetNodes;
+    std::atomic<std::uint64_t> skipListSetContains;
+    std::atomic<std::uint64_t> skipListSetNodes;
+};
+
+
+inline StatsCounters statsCounters{};
+
+
+
+// statsEnabled() returns true if the counters are being kept.
+constexpr bool statsEnabled() noexcept
+{
+    return SPELLCHECK_STATS != 0;
+}
+
+
+// statsSnapshot() returns the current values of the counters, all zero if
+// they aren't being kept.
+StatsSnapshot statsSnapshot() noexcept;
+
+
+// resetStats() sets every counter back to zero.
+void resetStats() noexcept;
+
+
+// prometheusText() returns the given snapshot as Prometheus metrics, each
+// a counter whose name begins with "spellcheck_".
+std::string prometheusText(const StatsSnapshot& snapshot);
+
+
+
+// A StatsTimer adds the time between its construction and its destruction,
+// in nanoseconds, to the given counter.
+class StatsTimer
+{
+public:
+    explicit StatsTimer(std::atomic<std::uint64_t>& counter) noexcept
+        : counter{counter}, start{std::chrono::steady_clock::now()}
+    {
+    }
+
+    ~StatsTimer() noexcept
+    {
+        auto elapsed = std::chrono::steady_clock::now() - start;
+        counter.fetch_add(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count(),
+                          std::memory_order_relaxed);
+    }
+
+    StatsTimer(const StatsTimer&) = delete;
+    StatsTimer& operator=(const StatsTimer&) = delete;
+
+private:
+    std::atomic<std::uint64_t>& counter;
+    std::chrono::steady_clock::time_point start;
+};
+
+
+
+// SPELLCHECK_COUNT(counter, n) adds n to the named member of statsCounters;
+// when the counters aren't kept, n is still evaluated (so that a variable
+// tallying it isn't reported as unused), but nothing else is done.
+// SPELLCHECK_TIME(counter) times the rest of the enclosing block.
+#if SPELLCHECK_STATS
+#define SPELLCHECK_COUNT(counter, n) (statsCounters.counter.fetch_add((n), std::memory_order_relaxed))
+#define SPELLCHECK_TIME(counter) StatsTimer spellcheckStatsTimer_{statsCounters.counter}
+#else
+#define SPELLCHECK_COUNT(counter, n) ((void)(n))
+#define SPELLCHECK_TIME(counter) ((void)0)
+#endif
+
+
+
+#endif // STATS_HPP
@@ -0,0 +1,189 @@
+// StringHash.hpp
+//
+// StringHash is a fast 64-bit hash of a string's bytes, following wyhash:
+// the string is read 8 or 16 bytes at a time, and each pair of words is
+// mixed by multiplying them into 128 bits and folding the halves together,
+// so that every bit of the result depends on every bit of the input.  Short
+// strings, which are most words, take a couple of overlapping loads and two
+// multiplications, with no loop at all.
+//
+// DefaultHash<T> is the hash a HashSet<T> uses when it isn't given one:
+// StringHash for strings, and otherwise std::hash, whose result is mixed
+// the same way, since std::hash of an integer is usually the integer
+// itself.  For a T without a std::hash, DefaultHash<T> can't be called
+// (as std::is_invocable can tell), rather than failing to compile.
+//
+// The hashes depend on the machine's byte order, so they're meant only for
+// tables in memory, not to be stored or sent anywhere.
+
+#ifndef STRINGHASH_HPP
+#define STRINGHASH_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <utility>
+
+
+
+namespace impl_
+{
+    constexpr std::uint64_t StringHash__secret[4] = {
+        0xa0761d6478bd642full, 0xe7037ed1a0b428dbull, 0x8ebc6af09c88c6e3ull, 0x589965cc75374cc3ull
+    };
+
+
+    // StringHash__multiply() replaces a and b with the low and high halves
+    // of their 128-bit product.
+    inline void StringHash__multiply(std::uint64_t& a, std::uint64_t& b) noexcept
+    {
+#if defined(__SIZEOF_INT128__)
+        unsigned __int128 product = static_cast<unsigned __int128>(a) * b;
+        a = static_cast<std::uint64_t>(product);
+        b = static_cast<std::uint64_t>(product >> 64);
+#else
+        std::uint64_t aHigh = a >> 32, aLow = static_cast<std::uint32_t>(a);
+        std::uint64_t bHigh = b >> 32, bLow = static_cast<std::uint32_t>(b);
+        std::uint64_t high = aHigh * bHigh, middle1 = aHigh * bLow, middle2 = aLow * bHigh, low = aLow * bLow;
+        std::uint64_t t = low + (middle1 << 32);
+        std::uint64_t carry = t < low;
+        std::uint64_t lo = t + (middle2 << 32);
+        carry += lo < t;
+        a = lo;
+        b = high + (middle1 >> 32) + (middle2 >> 32) + carry;
+#endif
+    }
+
+
+    inline std::uint64_t StringHash__mix(std::uint64_t a, std::uint64_t b) noexcept
+    {
+        StringHash__multiply(a, b);
+        return a ^ b;
+    }
+
+
+    inline std::uint64_t StringHash__read8(const unsigned char* p) noexcept
+    {
+        std::uint64_t v;
+        std::memcpy(&v, p, 8);
+        return v;
+    }
+
+
+    inline std::uint64_t StringHash__read4(const unsigned char* p) noexcept
+    {
+        std::uint32_t v;
+        std::memcpy(&v, p, 4);
+        return v;
+    }
+
+
+    // StringHash__read3() reads one to three bytes as one word.
+    inline std::uint64_t StringHash__read3(const unsigned char* p, std::size_t length) noexcept
+    {
+        return (std::uint64_t{p[0]} << 16) | (std::uint64_t{p[length >> 1]} << 8) | p[length - 1];
+    }
+}
+
+
+
+// hashBytes() returns the 64-bit hash of "length" bytes starting at "data".
+inline std::uint64_t hashBytes(const void* data, std::size_t length, std::uint64_t seed = 0) noexcept
+{
+    using namespace impl_;
+    const std::uint64_t* secret = StringHash__secret;
+    const unsigned char* p = static_cast<const unsigned char*>(data);
+    seed ^= StringHash__mix(seed ^ secret[0], secret[1]);
+
+    std::uint64_t a;
+    std::uint64_t b;
+    if(length <= 16)
+    {
+        if(length >= 4)
+        {
+            std::size_t offset = (length >> 3) << 2;
+            a = (StringHash__read4(p) << 32) | StringHash__read4(p + offset);
+            b = (StringHash__read4(p + length - 4) << 32) | StringHash__read4(p + length - 4 - offset);
+        }
+        else if(length > 0)
+        {
+            a = StringHash__read3(p, length);
+            b = 0;
+        }
+        else
+        {
+            a = b = 0;
+        }
+    }
+    else
+    {
+        std::size_t remaining = length;
+        if(remaining > 48)
+        {
+            // Three independent lanes, so that the multiplications overlap.
+            std::uint64_t seed1 = seed;
+            std::uint64_t seed2 = seed;
+            do
+            {
+                seed = StringHash__mix(StringHash__read8(p) ^ secret[1], StringHash__read8(p + 8) ^ seed);
+                seed1 = StringHash__mix(StringHash__read8(p + 16) ^ secret[2], StringHash__read8(p + 24) ^ seed1);
+                seed2 = StringHash__mix(StringHash__read8(p + 32) ^ secret[3], StringHash__read8(p + 40) ^ seed2);
+                p += 48;
+                remaining -= 48;
+            }
+            while(remaining > 48);
+            seed ^= seed1 ^ seed2;
+        }
+        while(remaining > 16)
+        {
+            seed = StringHash__mix(StringHash__read8(p) ^ secret[1], StringHash__read8(p + 8) ^ seed);
+            p += 16;
+            remaining -= 16;
+        }
+        // The last 16 bytes, which may overlap ones already read.
+        a = StringHash__read8(p + remaining - 16);
+        b = StringHash__read8(p + remaining - 8);
+    }
+
+    a ^= secret[1];
+    b ^= seed;
+    StringHash__multiply(a, b);
+    return StringHash__mix(a ^ secret[0] ^ length, b ^ secret[1]);
+}
+
+
+
+struct StringHash
+{
+    std::uint64_t operator()(std::string_view s) const noexcept
+    {
+        return hashBytes(s.data(), s.size());
+    }
+};
+
+
+
+template <typename T>
+struct DefaultHash
+{
+    template <typename U = T, typename = decltype(std::hash<U>{}(std::declval<const U&>()))>
+    std::uint64_t operator()(const T& element) const
+    {
+        return impl_::StringHash__mix(
+            static_cast<std::uint64_t>(std::hash<T>{}(element)) ^ impl_::StringHash__secret[0],
+            impl_::StringHash__secret[1]);
+    }
+};
+
+
+template <>
+struct DefaultHash<std::string> : StringHash
+{
+};
+
+
+
+#endif // STRINGHASH_HPP
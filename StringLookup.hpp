@@ -0,0 +1,71 @@
+// StringLookup.hpp
+//
+// A Set<std::string> can only be searched for a std::string, so a word that
+// is part of a larger string (a token in a document, one half of a split)
+// has to be copied into one first.  The Sets of strings that can instead be
+// searched for a std::string_view also derive from StringLookup, which
+// WordChecker finds with a dynamic_cast, as it finds a TrieSet.
+//
+// The Set templates (HashSet, AVLSet, SkipListSet) derive from
+// StringLookupFor<Derived, ElementType>, which is a StringLookup only when
+// ElementType is std::string, and implements containsView() by calling the
+// Derived's contains() with the view.  Their contains() accepts a view (or
+// anything that converts to one, such as a string literal) through a
+// member template enabled by StringLookup__isKey, rather than a plain
+// overload, which would make contains("word") ambiguous.
+
+#ifndef STRINGLOOKUP_HPP
+#define STRINGLOOKUP_HPP
+
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+
+
+class StringLookup
+{
+public:
+    virtual ~StringLookup() noexcept = default;
+
+    // containsView() returns true if the set contains a string equal to
+    // the given view, false otherwise.
+    virtual bool containsView(std::string_view element) const = 0;
+};
+
+
+
+template <typename Derived, typename ElementType>
+class StringLookupFor
+{
+};
+
+
+template <typename Derived>
+class StringLookupFor<Derived, std::string> : public StringLookup
+{
+public:
+    bool containsView(std::string_view element) const override
+    {
+        return static_cast<const Derived&>(*this).contains(element);
+    }
+};
+
+
+
+namespace impl_
+{
+    // StringLookup__isKey is true when a Set of ElementType can be searched
+    // for a Key without converting it into an ElementType: when the Set
+    // holds strings and the Key converts to a std::string_view (but isn't
+    // a std::string, which goes to the ordinary contains()).
+    template <typename ElementType, typename Key>
+    constexpr bool StringLookup__isKey =
+        std::is_same_v<ElementType, std::string>
+        && std::is_convertible_v<const Key&, std::string_view>
+        && !std::is_same_v<Key, std::string>;
+}
+
+
+
+#endif // STRINGLOOKUP_HPP
@@ -0,0 +1,156 @@
+// SuggestionCache.cpp
+
+#include "SuggestionCache.hpp"
+#include <functional>
+
+
+
+namespace
+{
+    // entryBytes() estimates the memory used by an entry: the strings'
+    // characters, their headers, and the list and hash table nodes that
+    // hold the entry.
+    std::size_t entryBytes(const std::string& word, const std::vector<std::string>& suggestions)
+    {
+        constexpr std::size_t NODE_OVERHEAD = 4 * sizeof(void*) + sizeof(std::string_view);
+        std::size_t bytes = NODE_OVERHEAD + sizeof(std::string) + sizeof(suggestions) + word.length();
+        for(const std::string& suggestion : suggestions)
+        {
+            bytes += sizeof(std::string) + suggestion.length();
+        }
+        return bytes;
+    }
+}
+
+
+SuggestionCache::SuggestionCache(std::size_t capacityInBytes, unsigned int shardCount)
+    : hits{0}, misses{0}, evictions{0}, invalidations{0}
+{
+    if(shardCount == 0)
+    {
+        shardCount = 1;
+    }
+    shards.reserve(shardCount);
+    for(unsigned int i = 0; i < shardCount; i++)
+    {
+        shards.push_back(std::make_unique<Shard>());
+    }
+    shardCapacity = capacityInBytes / shardCount;
+}
+
+
+bool SuggestionCache::find(const std::string& word, unsigned long generation, std::vector<std::string>& suggestions)
+{
+    Shard& shard = shardFor(word);
+    std::lock_guard<std::mutex> lock{shard.mutex};
+    auto found = shard.index.end();
+    if(checkGeneration(shard, generation))
+    {
+        found = shard.index.find(word);
+    }
+    if(found == shard.index.end())
+    {
+        misses.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    // Move the entry to the front, making it the most recently used.
+    shard.entries.splice(shard.entries.begin(), shard.entries, found->second);
+    suggestions = found->second->suggestions;
+    hits.fetch_add(1, std::memory_order_relaxed);
+    return true;
+}
+
+
+void SuggestionCache::insert(const std::string& word, unsigned long generation, const std::vector<std::string>& suggestions)
+{
+    std::size_t bytes = entryBytes(word, suggestions);
+    if(bytes > shardCapacity)
+    {
+        return;
+    }
+
+    Shard& shard = shardFor(word);
+    std::lock_guard<std::mutex> lock{shard.mutex};
+    if(!checkGeneration(shard, generation) || shard.index.find(word) != shard.index.end())
+    {
+        return;
+    }
+    while(shard.bytes + bytes > shardCapacity)
+    {
+        evict(shard);
+    }
+    shard.entries.push_front(Entry{word, suggestions, bytes});
+    shard.index.emplace(shard.entries.front().word, shard.entries.begin());
+    shard.bytes += bytes;
+}
+
+
+void SuggestionCache::clear()
+{
+    for(std::unique_ptr<Shard>& shard : shards)
+    {
+        std::lock_guard<std::mutex> lock{shard->mutex};
+        shard->index.clear();
+        shard->entries.clear();
+        shard->bytes = 0;
+    }
+}
+
+
+SuggestionCache::Statistics SuggestionCache::statistics() const
+{
+    Statistics result{
+        hits.load(std::memory_order_relaxed),
+        misses.load(std::memory_order_relaxed),
+        evictions.load(std::memory_order_relaxed),
+        invalidations.load(std::memory_order_relaxed),
+        0, 0};
+    for(const std::unique_ptr<Shard>& shard : shards)
+    {
+        std::lock_guard<std::mutex> lock{shard->mutex};
+        result.entries += shard->entries.size();
+        result.bytes += shard->bytes;
+    }
+    return result;
+}
+
+
+SuggestionCache::Shard& SuggestionCache::shardFor(const std::string& word)
+{
+    return *shards[std::hash<std::string>{}(word) % shards.size()];
+}
+
+
+bool SuggestionCache::checkGeneration(Shard& shard, unsigned long generation)
+{
+    // Generations only grow, so an older one comes from a caller that
+    // looked at the dictionary before it last changed, and is ignored
+    // rather than allowed to empty the shard (or roll it back).
+    if(generation < shard.generation)
+    {
+        return false;
+    }
+    if(generation > shard.generation)
+    {
+        if(!shard.entries.empty())
+        {
+            invalidations.fetch_add(1, std::memory_order_relaxed);
+        }
+        shard.index.clear();
+        shard.entries.clear();
+        shard.bytes = 0;
+        shard.generation = generation;
+    }
+    return true;
+}
+
+
+void SuggestionCache::evict(Shard& shard)
+{
+    const Entry& last = shard.entries.back();
+    shard.index.erase(last.word);
+    shard.bytes -= last.bytes;
+    shard.entries.pop_back();
+    evictions.fetch_add(1, std::memory_order_relaxed);
+}
@@ -0,0 +1,118 @@
+// SuggestionCache.hpp
+//
+// A SuggestionCache remembers the suggestions most recently found for each
+// misspelled word, so that a WordChecker asked again about the same word
+// (as happens constantly with real traffic, where a few thousand common
+// misspellings make up most requests) can skip generating them.
+//
+// The cache is safe to use from many threads at once.  It's divided into
+// shards, each a separate least-recently-used list guarded by its own
+// mutex and holding an equal share of the capacity, and a word always maps
+// to the same shard, so threads asking about different words rarely wait
+// on one another.
+//
+// Every entry is stored with the "generation" of the dictionary it was
+// computed from; WordChecker uses the size of its Set, which changes
+// whenever a word is added, so generations only grow.  A lookup with a
+// newer generation than a shard's entries were stored with empties that
+// shard first, so that suggestions never outlive the dictionary they came
+// from; a lookup or insertion with an older one (from a thread that read
+// the generation before the dictionary last grew) finds nothing and
+// stores nothing.  clear() can be called to drop everything after any
+// other kind of change.
+
+#ifndef SUGGESTIONCACHE_HPP
+#define SUGGESTIONCACHE_HPP
+
+#include <atomic>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+
+
+class SuggestionCache
+{
+public:
+    // A Statistics object is a snapshot of a cache's counters.
+    struct Statistics
+    {
+        unsigned long long hits;
+        unsigned long long misses;
+        unsigned long long evictions;
+        unsigned long long invalidations;
+        std::size_t entries;
+        std::size_t bytes;
+    };
+
+public:
+    // Initializes an empty cache that holds at most (approximately)
+    // capacityInBytes bytes of words and suggestions, divided among the
+    // given number of shards.
+    explicit SuggestionCache(std::size_t capacityInBytes, unsigned int shardCount = 16);
+
+    SuggestionCache(const SuggestionCache& c) = delete;
+    SuggestionCache& operator=(const SuggestionCache& c) = delete;
+
+
+    // find() copies the cached suggestions for the given word into
+    // "suggestions" and returns true, or returns false if there are none
+    // for the given dictionary generation.
+    bool find(const std::string& word, unsigned long generation, std::vector<std::string>& suggestions);
+
+
+    // insert() caches the suggestions for the given word, evicting the
+    // least recently used entries of its shard to make room.  Entries too
+    // large to fit in a shard at all are not cached.
+    void insert(const std::string& word, unsigned long generation, const std::vector<std::string>& suggestions);
+
+
+    // clear() removes every entry from the cache.
+    void clear();
+
+
+    // statistics() returns a snapshot of the cache's counters.
+    Statistics statistics() const;
+
+
+private:
+    struct Entry
+    {
+        std::string word;
+        std::vector<std::string> suggestions;
+        std::size_t bytes;
+    };
+
+    struct Shard
+    {
+        std::mutex mutex;
+        std::list<Entry> entries;
+        std::unordered_map<std::string_view, std::list<Entry>::iterator> index;
+        std::size_t bytes = 0;
+        unsigned long generation = 0;
+    };
+
+    std::vector<std::unique_ptr<Shard>> shards;
+    std::size_t shardCapacity;
+    std::atomic<unsigned long long> hits;
+    std::atomic<unsigned long long> misses;
+    std::atomic<unsigned long long> evictions;
+    std::atomic<unsigned long long> invalidations;
+
+    Shard& shardFor(const std::string& word);
+
+    // The functions below expect the shard's mutex to be locked.
+
+    // checkGeneration() empties the shard if the given generation is newer
+    // than its own, and returns false if it's older.
+    bool checkGeneration(Shard& shard, unsigned long generation);
+    void evict(Shard& shard);
+};
+
+
+
+#endif // SUGGESTIONCACHE_HPP
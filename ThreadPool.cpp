@@ -0,0 +1,58 @@
+// ThreadPool.cpp
+
+#include "ThreadPool.hpp"
+
+
+ThreadPool::ThreadPool(unsigned int threadCount)
+    : stopping{false}
+{
+    if(threadCount == 0)
+    {
+        threadCount = 1;
+    }
+    threads.reserve(threadCount);
+    for(unsigned int i = 0; i < threadCount; i++)
+    {
+        threads.emplace_back([this]() { runWorker(); });
+    }
+}
+
+
+ThreadPool::~ThreadPool() noexcept
+{
+    {
+        std::lock_guard<std::mutex> lock{mutex};
+        stopping = true;
+    }
+    taskReady.notify_all();
+    for(std::thread& thread : threads)
+    {
+        thread.join();
+    }
+}
+
+
+unsigned int ThreadPool::threadCount() const noexcept
+{
+    return threads.size();
+}
+
+
+void ThreadPool::runWorker()
+{
+    while(true)
+    {
+        std::function<void()> task;
+        {
+            std::unique_lock<std::mutex> lock{mutex};
+            taskReady.wait(lock, [this]() { return stopping || !tasks.empty(); });
+            if(tasks.empty())
+            {
+                return;
+            }
+            task = std::move(tasks.front());
+            tasks.pop_front();
+        }
+        task();
+    }
+}
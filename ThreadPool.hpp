@@ -0,0 +1,82 @@
+// ThreadPool.hpp
+//
+// A ThreadPool owns a fixed number of worker threads that run submitted
+// tasks in the order they were submitted.  The threads are started once,
+// when the pool is constructed, and reused for every task, so that callers
+// (such as a WordChecker generating suggestions in parallel) don't pay for
+// starting a thread per request.
+//
+// Destroying the pool finishes every task that has already been submitted,
+// then joins the worker threads.
+
+#ifndef THREADPOOL_HPP
+#define THREADPOOL_HPP
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+
+
+class ThreadPool
+{
+public:
+    // Initializes a ThreadPool with the given number of worker threads,
+    // which defaults to the number of hardware threads (and is at least 1).
+    explicit ThreadPool(unsigned int threadCount = std::thread::hardware_concurrency());
+
+    // Runs every task still waiting, then joins the worker threads.
+    ~ThreadPool() noexcept;
+
+    ThreadPool(const ThreadPool& p) = delete;
+    ThreadPool& operator=(const ThreadPool& p) = delete;
+
+
+    // submit() queues a task to be run on one of the worker threads and
+    // returns a future that becomes ready with the task's result (or the
+    // exception it threw) once it has run.
+    template <typename Task>
+    std::future<std::invoke_result_t<Task>> submit(Task task);
+
+
+    // threadCount() returns the number of worker threads.
+    unsigned int threadCount() const noexcept;
+
+
+private:
+    std::vector<std::thread> threads;
+    std::deque<std::function<void()>> tasks;
+    std::mutex mutex;
+    std::condition_variable taskReady;
+    bool stopping;
+
+    void runWorker();
+};
+
+
+
+template <typename Task>
+std::future<std::invoke_result_t<Task>> ThreadPool::submit(Task task)
+{
+    // std::function requires a copyable target, so the packaged_task (which
+    // can only be moved) is shared instead.
+    using Result = std::invoke_result_t<Task>;
+    auto packaged = std::make_shared<std::packaged_task<Result()>>(std::move(task));
+    std::future<Result> result = packaged->get_future();
+    {
+        std::lock_guard<std::mutex> lock{mutex};
+        tasks.emplace_back([packaged]() { (*packaged)(); });
+    }
+    taskReady.notify_one();
+    return result;
+}
+
+
+
+#endif // THREADPOOL_HPP
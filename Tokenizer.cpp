@@ -0,0 +1,198 @@
+// Tokenizer.cpp
+
+#include "Tokenizer.hpp"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define TOKENIZER_X86 1
+#include <immintrin.h>
+#else
+#define TOKENIZER_X86 0
+#endif
+
+
+
+namespace
+{
+    constexpr std::size_t BLOCK_SIZE = 64;
+
+
+    bool isLetter(char c) noexcept
+    {
+        // Setting bit 5 maps 'A'..'Z' onto 'a'..'z' and leaves no other byte
+        // in that range.
+        return static_cast<unsigned char>((c | 0x20) - 'a') < 26;
+    }
+
+
+    // scalarBytes() classifies and uppercases "length" (at most 64) bytes.
+    std::uint64_t scalarBytes(const char* text, char* upper, std::size_t length) noexcept
+    {
+        std::uint64_t mask = 0;
+        for(std::size_t i = 0; i < length; i++)
+        {
+            char c = text[i];
+            bool letter = isLetter(c);
+            mask |= std::uint64_t{letter} << i;
+            upper[i] = (letter && (c & 0x20)) ? c & ~0x20 : c;
+        }
+        return mask;
+    }
+
+
+    std::uint64_t scalarBlock(const char* text, char* upper)
+    {
+        return scalarBytes(text, upper, BLOCK_SIZE);
+    }
+
+
+#if TOKENIZER_X86
+    // The vector versions compute, for each byte c, whether (c | 0x20) - 'a'
+    // is below 26 as unsigned bytes (there's no unsigned byte comparison,
+    // but min(x, 25) == x is the same test), then clear bit 5 of the letters
+    // that have it set, which are the lowercase ones.
+
+    std::uint64_t sse2Block(const char* text, char* upper)
+    {
+        const __m128i caseBit = _mm_set1_epi8(0x20);
+        const __m128i a = _mm_set1_epi8('a');
+        const __m128i maxOffset = _mm_set1_epi8(25);
+        std::uint64_t mask = 0;
+        for(int i = 0; i < 4; i++)
+        {
+            __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(text + 16 * i));
+            __m128i offset = _mm_sub_epi8(_mm_or_si128(v, caseBit), a);
+            __m128i letter = _mm_cmpeq_epi8(_mm_min_epu8(offset, maxOffset), offset);
+            __m128i lower = _mm_and_si128(letter, _mm_and_si128(v, caseBit));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(upper + 16 * i), _mm_xor_si128(v, lower));
+            mask |= std::uint64_t(static_cast<std::uint16_t>(_mm_movemask_epi8(letter))) << (16 * i);
+        }
+        return mask;
+    }
+
+
+    __attribute__((target("avx2")))
+    std::uint64_t avx2Block(const char* text, char* upper)
+    {
+        const __m256i caseBit = _mm256_set1_epi8(0x20);
+        const __m256i a = _mm256_set1_epi8('a');
+        const __m256i maxOffset = _mm256_set1_epi8(25);
+        std::uint64_t mask = 0;
+        for(int i = 0; i < 2; i++)
+        {
+            __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(text + 32 * i));
+            __m256i offset = _mm256_sub_epi8(_mm256_or_si256(v, caseBit), a);
+            __m256i letter = _mm256_cmpeq_epi8(_mm256_min_epu8(offset, maxOffset), offset);
+            __m256i lower = _mm256_and_si256(letter, _mm256_and_si256(v, caseBit));
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(upper + 32 * i), _mm256_xor_si256(v, lower));
+            mask |= std::uint64_t(static_cast<std::uint32_t>(_mm256_movemask_epi8(letter))) << (32 * i);
+        }
+        return mask;
+    }
+#endif
+
+
+    bool isSupported(Tokenizer::Implementation implementation) noexcept
+    {
+        switch(implementation)
+        {
+#if TOKENIZER_X86
+        case Tokenizer::Implementation::AVX2:
+            return __builtin_cpu_supports("avx2");
+        case Tokenizer::Implementation::SSE2:
+            return __builtin_cpu_supports("sse2");
+#endif
+        case Tokenizer::Implementation::Scalar:
+            return true;
+        default:
+            return false;
+        }
+    }
+
+
+    Tokenizer::Implementation fastestSupported() noexcept
+    {
+        if(isSupported(Tokenizer::Implementation::AVX2))
+        {
+            return Tokenizer::Implementation::AVX2;
+        }
+        if(isSupported(Tokenizer::Implementation::SSE2))
+        {
+            return Tokenizer::Implementation::SSE2;
+        }
+        return Tokenizer::Implementation::Scalar;
+    }
+
+
+    // addTokens() reads word boundaries off one block's letter mask.  A bit
+    // of "changes" is set wherever a byte's letter bit differs from the
+    // previous byte's (carried over from the last block), so each one is
+    // either the start of a word or the end of one; they're visited lowest
+    // first, clearing each in turn.
+    void addTokens(std::uint64_t mask, std::size_t base, bool& inWord, std::size_t& wordStart,
+                   std::vector<Tokenizer::Token>& tokens)
+    {
+        std::uint64_t changes = mask ^ ((mask << 1) | std::uint64_t{inWord});
+        while(changes != 0)
+        {
+            std::size_t position = base + __builtin_ctzll(changes);
+            if(inWord)
+            {
+                tokens.push_back(Tokenizer::Token{wordStart, position - wordStart});
+            }
+            else
+            {
+                wordStart = position;
+            }
+            inWord = !inWord;
+            changes &= changes - 1;
+        }
+    }
+}
+
+
+Tokenizer::Tokenizer()
+    : Tokenizer{fastestSupported()}
+{
+}
+
+
+Tokenizer::Tokenizer(Implementation implementation)
+    : chosen{isSupported(implementation) ? implementation : fastestSupported()}, block{scalarBlock}
+{
+#if TOKENIZER_X86
+    if(chosen == Implementation::AVX2)
+    {
+        block = avx2Block;
+    }
+    else if(chosen == Implementation::SSE2)
+    {
+        block = sse2Block;
+    }
+#endif
+}
+
+
+Tokenizer::Implementation Tokenizer::implementation() const noexcept
+{
+    return chosen;
+}
+
+
+void Tokenizer::tokenize(const char* text, std::size_t length, char* upper, std::vector<Token>& tokens) const
+{
+    bool inWord = false;
+    std::size_t wordStart = 0;
+    std::size_t i = 0;
+    for(; i + BLOCK_SIZE <= length; i += BLOCK_SIZE)
+    {
+        addTokens(block(text + i, upper + i), i, inWord, wordStart, tokens);
+    }
+    if(i < length)
+    {
+        addTokens(scalarBytes(text + i, upper + i, length - i), i, inWord, wordStart, tokens);
+    }
+    if(inWord)
+    {
+        tokens.push_back(Token{wordStart, length - wordStart});
+    }
+}
@@ -0,0 +1,75 @@
+// Tokenizer.hpp
+//
+// A Tokenizer splits text into words (runs of ASCII letters) and, in the
+// same pass, uppercases the text's letters, since WordChecker's dictionary
+// words and generated candidates are uppercase.
+//
+// The text is classified 64 bytes at a time into a 64-bit mask with one bit
+// per byte that is a letter; word boundaries are then read off the places
+// where the mask changes, a word at a time rather than a byte at a time.
+// Building the mask (and the uppercased copy) uses AVX2 or SSE2 where the
+// processor supports it, and plain C++ elsewhere; the choice is made once,
+// at run time, when the Tokenizer is constructed.
+
+#ifndef TOKENIZER_HPP
+#define TOKENIZER_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+
+
+class Tokenizer
+{
+public:
+    // A Token is a word's offset from the start of the tokenized text and
+    // its length, both in bytes.
+    struct Token
+    {
+        std::size_t offset;
+        std::size_t length;
+    };
+
+    // Implementation names the ways in which the masks can be built.
+    enum class Implementation
+    {
+        Scalar,
+        SSE2,
+        AVX2
+    };
+
+public:
+    // Initializes a Tokenizer using the fastest implementation supported
+    // by the processor.
+    Tokenizer();
+
+    // Initializes a Tokenizer using the given implementation, or the
+    // fastest supported one if the processor doesn't support it.
+    explicit Tokenizer(Implementation implementation);
+
+
+    // implementation() returns the implementation in use.
+    Implementation implementation() const noexcept;
+
+
+    // tokenize() appends a Token to "tokens" for each word in the given
+    // text, in order, and writes an uppercased copy of the text (with only
+    // its ASCII lowercase letters changed) to "upper", which must have room
+    // for "length" bytes.  A word that runs up to the end of the text is
+    // reported as it is, even though it may continue past the end.
+    void tokenize(const char* text, std::size_t length, char* upper, std::vector<Token>& tokens) const;
+
+
+private:
+    // A BlockFunction classifies and uppercases 64 bytes of text, returning
+    // the letter mask, whose bit i is set if byte i is a letter.
+    using BlockFunction = std::uint64_t (*)(const char* text, char* upper);
+
+    Implementation chosen;
+    BlockFunction block;
+};
+
+
+
+#endif // TOKENIZER_HPP
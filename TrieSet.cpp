@@ -0,0 +1,365 @@
+// TrieSet.cpp
+
+#include "TrieSet.hpp"
+#include <algorithm>
+#include <utility>
+
+
+
+namespace
+{
+    // Siblings are kept in increasing order of their characters, compared as
+    // unsigned values so that bytes above 127 sort after ASCII.
+    bool comesBefore(char a, char b)
+    {
+        return static_cast<unsigned char>(a) < static_cast<unsigned char>(b);
+    }
+
+
+    const NodeT* findChild(const NodeT* node, char letter)
+    {
+        if(node == nullptr)
+        {
+            return nullptr;
+        }
+        for(const NodeT* c = node->child; c != nullptr && !comesBefore(letter, c->letter); c = c->sibling)
+        {
+            if(c->letter == letter)
+            {
+                return c;
+            }
+        }
+        return nullptr;
+    }
+
+
+    // walk() follows the characters in [begin, end) down from the given
+    // node, returning the node reached, or nullptr if the path leaves the
+    // trie (or the given node is nullptr).
+    const NodeT* walk(const NodeT* node, const char* begin, const char* end)
+    {
+        while(node != nullptr && begin != end)
+        {
+            node = findChild(node, *begin);
+            begin++;
+        }
+        return node;
+    }
+
+
+    bool isWord(const NodeT* node)
+    {
+        return node != nullptr && node->isWord;
+    }
+
+
+    // addPath() follows the characters in [begin, end) down from the given
+    // node, adding nodes for those that aren't there yet, and marks the node
+    // reached as a word.  It returns true if that node wasn't a word before.
+    template <typename Iterator>
+    bool addPath(NodeT* current, Iterator begin, Iterator end)
+    {
+        for(; begin != end; ++begin)
+        {
+            char letter = *begin;
+            NodeT** link = &current->child;
+            while(*link != nullptr && comesBefore((*link)->letter, letter))
+            {
+                link = &(*link)->sibling;
+            }
+            if(*link == nullptr || (*link)->letter != letter)
+            {
+                *link = new NodeT{letter, false, nullptr, *link};
+            }
+            current = *link;
+        }
+        bool added = !current->isWord;
+        current->isWord = true;
+        return added;
+    }
+
+
+    // pathLengths() follows the characters in [begin, end) down from the
+    // given node, appending the number of characters followed each time it
+    // reaches a word.
+    template <typename Iterator>
+    void pathLengths(const NodeT* node, Iterator begin, Iterator end, std::vector<std::size_t>& lengths)
+    {
+        for(std::size_t length = 0; node != nullptr; length++, ++begin)
+        {
+            if(node->isWord)
+            {
+                lengths.push_back(length);
+            }
+            if(begin == end)
+            {
+                break;
+            }
+            node = findChild(node, *begin);
+        }
+    }
+}
+
+
+TrieSet::TrieSet()
+    : TrieSet{false}
+{
+}
+
+
+TrieSet::TrieSet(bool indexSuffixes)
+    : root{new NodeT{'\0', false, nullptr, nullptr}}, reverseRoot{nullptr}, sz{0}
+{
+    if(indexSuffixes)
+    {
+        try
+        {
+            reverseRoot = new NodeT{'\0', false, nullptr, nullptr};
+        }
+        catch(...)
+        {
+            delete root;
+            throw;
+        }
+    }
+}
+
+
+TrieSet::~TrieSet() noexcept
+{
+    deleteHelper(root);
+    deleteHelper(reverseRoot);
+}
+
+
+TrieSet::TrieSet(const TrieSet& s)
+    : root{copyHelper(s.root)}, reverseRoot{nullptr}, sz{s.sz}
+{
+    try
+    {
+        reverseRoot = copyHelper(s.reverseRoot);
+    }
+    catch(...)
+    {
+        deleteHelper(root);
+        throw;
+    }
+}
+
+
+TrieSet::TrieSet(TrieSet&& s) noexcept
+    : root{s.root}, reverseRoot{s.reverseRoot}, sz{s.sz}
+{
+    // The moved-from TrieSet is left empty, without even a root, which the
+    // lookups treat as an empty trie and add() replaces.
+    s.root = nullptr;
+    s.reverseRoot = nullptr;
+    s.sz = 0;
+}
+
+
+TrieSet& TrieSet::operator=(const TrieSet& s)
+{
+    if(this != &s)
+    {
+        TrieSet copy{s};
+        std::swap(root, copy.root);
+        std::swap(reverseRoot, copy.reverseRoot);
+        std::swap(sz, copy.sz);
+    }
+    return *this;
+}
+
+
+TrieSet& TrieSet::operator=(TrieSet&& s) noexcept
+{
+    std::swap(root, s.root);
+    std::swap(reverseRoot, s.reverseRoot);
+    std::swap(sz, s.sz);
+    return *this;
+}
+
+
+bool TrieSet::isImplemented() const noexcept
+{
+    return true;
+}
+
+
+void TrieSet::add(const std::string& element)
+{
+    if(root == nullptr)
+    {
+        root = new NodeT{'\0', false, nullptr, nullptr};
+    }
+    if(addPath(root, element.begin(), element.end()))
+    {
+        sz++;
+    }
+    if(reverseRoot != nullptr)
+    {
+        addPath(reverseRoot, element.rbegin(), element.rend());
+    }
+}
+
+
+bool TrieSet::contains(const std::string& element) const
+{
+    return containsView(element);
+}
+
+
+bool TrieSet::containsView(std::string_view element) const
+{
+    return isWord(walk(root, element.data(), element.data() + element.length()));
+}
+
+
+unsigned int TrieSet::size() const noexcept
+{
+    return sz;
+}
+
+
+void TrieSet::findEdits(const std::string& word, TrieEdit edit, std::size_t first, std::size_t last,
+                        std::string_view letters, VisitFunction visit) const
+{
+    bool isLetter[256] = {};
+    for(char letter : letters)
+    {
+        isLetter[static_cast<unsigned char>(letter)] = true;
+    }
+
+    const char* begin = word.data();
+    const char* end = begin + word.length();
+    std::size_t n = word.length();
+
+    // An edit at position i leaves word[0..i) untouched, so every candidate
+    // starts from the node for that prefix; once the prefix isn't in the
+    // trie, no edit at or beyond i can produce a word.
+    const NodeT* prefix = walk(root, begin, begin + std::min(first, n));
+    std::string candidate;
+    candidate.reserve(n + 1);
+
+    for(std::size_t i = first; i < last && i <= n && prefix != nullptr; i++)
+    {
+        switch(edit)
+        {
+        case TrieEdit::Swap:
+            if(i + 1 < n)
+            {
+                const NodeT* node = findChild(walk(prefix, begin + i + 1, begin + i + 2), word[i]);
+                if(isWord(walk(node, begin + i + 2, end)))
+                {
+                    candidate.assign(word);
+                    std::swap(candidate[i], candidate[i + 1]);
+                    visit(candidate);
+                }
+            }
+            break;
+
+        case TrieEdit::Insert:
+            for(const NodeT* c = prefix->child; c != nullptr; c = c->sibling)
+            {
+                if(isLetter[static_cast<unsigned char>(c->letter)] && isWord(walk(c, begin + i, end)))
+                {
+                    candidate.assign(word);
+                    candidate.insert(i, 1, c->letter);
+                    visit(candidate);
+                }
+            }
+            break;
+
+        case TrieEdit::Delete:
+            if(i < n && isWord(walk(prefix, begin + i + 1, end)))
+            {
+                candidate.assign(word);
+                candidate.erase(i, 1);
+                visit(candidate);
+            }
+            break;
+
+        case TrieEdit::Replace:
+            for(const NodeT* c = prefix->child; c != nullptr && i < n; c = c->sibling)
+            {
+                if(isLetter[static_cast<unsigned char>(c->letter)] && isWord(walk(c, begin + i + 1, end)))
+                {
+                    candidate.assign(word);
+                    candidate[i] = c->letter;
+                    visit(candidate);
+                }
+            }
+            break;
+        }
+
+        if(i < n)
+        {
+            prefix = findChild(prefix, word[i]);
+        }
+    }
+}
+
+
+void TrieSet::prefixLengths(std::string_view word, std::vector<std::size_t>& lengths) const
+{
+    pathLengths(root, word.begin(), word.end(), lengths);
+}
+
+
+void TrieSet::suffixLengths(std::string_view word, std::vector<std::size_t>& lengths) const
+{
+    if(reverseRoot != nullptr)
+    {
+        pathLengths(reverseRoot, word.rbegin(), word.rend(), lengths);
+        return;
+    }
+
+    const char* end = word.data() + word.length();
+    for(std::size_t length = 0; length <= word.length(); length++)
+    {
+        if(isWord(walk(root, end - length, end)))
+        {
+            lengths.push_back(length);
+        }
+    }
+}
+
+
+bool TrieSet::hasSuffixIndex() const noexcept
+{
+    return reverseRoot != nullptr;
+}
+
+
+void TrieSet::deleteHelper(NodeT* node) noexcept
+{
+    while(node != nullptr)
+    {
+        NodeT* sibling = node->sibling;
+        deleteHelper(node->child);
+        delete node;
+        node = sibling;
+    }
+}
+
+
+NodeT* TrieSet::copyHelper(const NodeT* node)
+{
+    NodeT* first = nullptr;
+    NodeT** link = &first;
+    try
+    {
+        for(; node != nullptr; node = node->sibling)
+        {
+            *link = new NodeT{node->letter, node->isWord, nullptr, nullptr};
+            (*link)->child = copyHelper(node->child);
+            link = &(*link)->sibling;
+        }
+    }
+    catch(...)
+    {
+        deleteHelper(first);
+        throw;
+    }
+    return first;
+}
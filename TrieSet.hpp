@@ -0,0 +1,163 @@
+// TrieSet.hpp
+//
+// A TrieSet is an implementation of a Set of strings that is a trie: each
+// node stands for one character, and the path from the root to a node
+// spells out a prefix shared by every word stored beneath it.  The children
+// of a node are kept in a singly-linked list of siblings, sorted by their
+// characters, so a node costs the same no matter how large the alphabet is.
+//
+// Besides the usual Set operations, a TrieSet can find every word that is
+// a single edit away from a given word in one walk (see findEdits()).
+// Candidates that share a prefix share the walk down to it, and a branch of
+// the trie that no word continues is abandoned as soon as it is reached,
+// rather than every candidate being built and then looked up in full.
+//
+// It can also find every word that is a prefix of a given word in one walk
+// down the trie (see prefixLengths()).  When asked to when it's
+// constructed, a TrieSet keeps a second trie of its words spelled
+// backward, so that every word that is a suffix of a given word can be
+// found in one walk, too (see suffixLengths()).
+//
+// Like the other Set implementations, this one uses its own dynamically-
+// allocated nodes rather than the containers in the C++ Standard Library.
+
+#ifndef TRIESET_HPP
+#define TRIESET_HPP
+
+#include <functional>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+#include "Set.hpp"
+#include "StringLookup.hpp"
+
+struct NodeT
+{
+    char letter;
+    bool isWord;
+    NodeT* child;
+    NodeT* sibling;
+};
+
+
+// TrieEdit names the kinds of single edits that findEdits() can apply.
+enum class TrieEdit
+{
+    Swap,
+    Insert,
+    Delete,
+    Replace
+};
+
+
+class TrieSet : public Set<std::string>, public StringLookup
+{
+public:
+    // A VisitFunction is a function that takes a reference to a const
+    // string and returns no value.
+    using VisitFunction = std::function<void(const std::string&)>;
+
+public:
+    // Initializes a TrieSet to be empty.  If indexSuffixes is true, the
+    // TrieSet also keeps its words spelled backward, which costs roughly
+    // twice the memory and time to add words, but lets suffixLengths() find
+    // suffixes in one walk.
+    TrieSet();
+    explicit TrieSet(bool indexSuffixes);
+
+    // Cleans up the TrieSet so that it leaks no memory.
+    ~TrieSet() noexcept override;
+
+    // Initializes a new TrieSet to be a copy of an existing one.
+    TrieSet(const TrieSet& s);
+
+    // Initializes a new TrieSet whose contents are moved from an
+    // expiring one.
+    TrieSet(TrieSet&& s) noexcept;
+
+    // Assigns an existing TrieSet into another.
+    TrieSet& operator=(const TrieSet& s);
+
+    // Assigns an expiring TrieSet into another.
+    TrieSet& operator=(TrieSet&& s) noexcept;
+
+
+    bool isImplemented() const noexcept override;
+
+
+    // add() adds an element to the set.  If the element is already in the
+    // set, this function has no effect.  This function runs in O(n * a)
+    // time for an element of length n, where a is the number of distinct
+    // characters that can follow any one prefix.
+    void add(const std::string& element) override;
+
+
+    // contains() returns true if the given element is already in the set,
+    // false otherwise.  This function runs in O(n * a) time, like add().
+    bool contains(const std::string& element) const override;
+
+    // A TrieSet can also be searched for a std::string_view, which is
+    // walked down the trie in place.
+    template <typename Key, typename = std::enable_if_t<impl_::StringLookup__isKey<std::string, Key>>>
+    bool contains(const Key& element) const
+    {
+        return containsView(element);
+    }
+
+    bool containsView(std::string_view element) const override;
+
+
+    // size() returns the number of elements in the set.
+    unsigned int size() const noexcept override;
+
+
+    // findEdits() calls the given "visit" function for every word in the
+    // set that can be made from the given word by one edit of the given
+    // kind, applied at a position in [first, last):
+    //
+    //   * Swap swaps the characters at positions i and i + 1
+    //   * Insert inserts one of the given letters just before the character
+    //     at position i (or at the end, if i is the word's length)
+    //   * Delete deletes the character at position i
+    //   * Replace replaces the character at position i with one of the
+    //     given letters
+    //
+    // The words are visited in increasing order of position, then letter,
+    // which is the order in which WordChecker generates the same edits; a
+    // word reachable more than one way is visited each time.
+    void findEdits(const std::string& word, TrieEdit edit, std::size_t first, std::size_t last,
+                   std::string_view letters, VisitFunction visit) const;
+
+
+    // prefixLengths() appends to "lengths", in increasing order, every
+    // length L such that the first L characters of the given word are a
+    // word in the set (including L = 0 if the empty string is in the set).
+    // The lengths are found in one walk down the trie.
+    void prefixLengths(std::string_view word, std::vector<std::size_t>& lengths) const;
+
+
+    // suffixLengths() appends to "lengths", in increasing order, every
+    // length L such that the last L characters of the given word are a word
+    // in the set.  With the suffix index, they're found in one walk down it;
+    // without it, each suffix is looked up separately.
+    void suffixLengths(std::string_view word, std::vector<std::size_t>& lengths) const;
+
+
+    // hasSuffixIndex() returns true if the TrieSet keeps its words spelled
+    // backward.
+    bool hasSuffixIndex() const noexcept;
+
+
+private:
+    NodeT* root;
+    NodeT* reverseRoot;
+    int sz;
+
+    void deleteHelper(NodeT* node) noexcept;
+    NodeT* copyHelper(const NodeT* node);
+};
+
+
+
+#endif // TRIESET_HPP
@@ -0,0 +1,109 @@
+// Utf8.hpp
+//
+// A few small functions for working with words encoded in UTF-8, used by
+// WordChecker's suggestion generators to edit words one code point at a
+// time, rather than one byte at a time, so that they never build an
+// invalid UTF-8 sequence (which can't be a word) and waste a probe on it.
+//
+// Since nearly every word is pure ASCII, in which bytes and code points
+// are the same thing, isAscii() is the check that decides whether the
+// slower code point path is needed at all; it looks at 16 bytes at a time
+// with SSE2 where that's available, and 8 bytes at a time otherwise.
+
+#ifndef UTF8_HPP
+#define UTF8_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+
+
+// isAscii() returns true if no byte of the given text has its high bit
+// set, i.e., if every character of it is a single-byte code point.
+inline bool isAscii(std::string_view text) noexcept
+{
+    const char* p = text.data();
+    std::size_t n = text.length();
+
+#if defined(__SSE2__)
+    for(; n >= 16; p += 16, n -= 16)
+    {
+        __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+        if(_mm_movemask_epi8(bytes) != 0)
+        {
+            return false;
+        }
+    }
+#endif
+
+    for(; n >= 8; p += 8, n -= 8)
+    {
+        std::uint64_t bytes;
+        std::memcpy(&bytes, p, 8);
+        if((bytes & 0x8080808080808080ull) != 0)
+        {
+            return false;
+        }
+    }
+
+    for(; n > 0; p++, n--)
+    {
+        if(static_cast<unsigned char>(*p) >= 0x80)
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+
+// isContinuationByte() returns true if the given byte continues a
+// multi-byte code point (10xxxxxx), rather than starting one.  Every other
+// byte is treated as the start of a code point, so that even a malformed
+// word is divided into whole units that edits can move around intact.
+constexpr bool isContinuationByte(char c) noexcept
+{
+    return (static_cast<unsigned char>(c) & 0xC0) == 0x80;
+}
+
+
+// nextCodePoint() returns the position just past the code point that
+// starts at the given position of the given text.
+inline std::size_t nextCodePoint(std::string_view text, std::size_t position) noexcept
+{
+    do
+    {
+        position++;
+    }
+    while(position < text.length() && isContinuationByte(text[position]));
+
+    return position;
+}
+
+
+// encodeLatin1() stores the UTF-8 encoding of the code point U+0000
+// through U+00FF whose value is the given (Latin-1) byte into "out",
+// returning how many bytes (1 or 2) it takes.
+constexpr std::size_t encodeLatin1(char c, char* out) noexcept
+{
+    unsigned char value = static_cast<unsigned char>(c);
+    if(value < 0x80)
+    {
+        out[0] = c;
+        return 1;
+    }
+    out[0] = static_cast<char>(0xC0 | (value >> 6));
+    out[1] = static_cast<char>(0x80 | (value & 0x3F));
+    return 2;
+}
+
+
+
+#endif // UTF8_HPP
@@ -7,11 +7,155 @@
 // the requirements.
 
 #include "WordChecker.hpp"
-#include <iostream>
+#include "CancellationToken.hpp"
+#include "DeletionIndex.hpp"
+#include "KeyboardLayout.hpp"
+#include "LengthBucketIndex.hpp"
+#include "Stats.hpp"
+#include "StringLookup.hpp"
+#include "SuggestionCache.hpp"
+#include "ThreadPool.hpp"
+#include "TrieSet.hpp"
+#include "Utf8.hpp"
+#include <algorithm>
+#include <functional>
+#include <future>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+
+
+
+namespace
+{
+    // countProbe() and countHit() keep the per-strategy counters described
+    // in Stats.hpp, when they're kept at all.
+    void countProbe([[maybe_unused]] SuggestionStrategy strategy)
+    {
+        SPELLCHECK_COUNT(suggestionProbes[static_cast<std::size_t>(strategy)], 1);
+    }
+
+
+    void countHit([[maybe_unused]] SuggestionStrategy strategy)
+    {
+        SPELLCHECK_COUNT(suggestionHits[static_cast<std::size_t>(strategy)], 1);
+    }
+
+
+    SuggestionStrategy strategyOf(TrieEdit edit)
+    {
+        switch(edit)
+        {
+        case TrieEdit::Swap:
+            return SuggestionStrategy::Swap;
+        case TrieEdit::Insert:
+            return SuggestionStrategy::Insert;
+        case TrieEdit::Delete:
+            return SuggestionStrategy::Delete;
+        default: // TrieEdit::Replace
+            return SuggestionStrategy::Replace;
+        }
+    }
+}
+
+
+
+// A Suggestions object remembers which candidates have already been added
+// in a small open-addressed table of indices into the output vector, so
+// each add() costs one hash instead of a scan over everything added so far.
+// The table is only allocated once the first candidate arrives.
+
+class WordChecker::Suggestions
+{
+public:
+    explicit Suggestions(std::vector<std::string>& output);
+
+    // add() appends the candidate to the output unless it was added before.
+    void add(const std::string& candidate);
+
+private:
+    static constexpr std::size_t INITIAL_SLOTS = 64;
+    static constexpr int EMPTY = -1;
+
+    struct Slot
+    {
+        std::size_t hash;
+        int index;
+    };
+
+    std::vector<std::string>& output;
+    std::vector<Slot> slots;
+
+    void grow();
+};
+
+
+WordChecker::Suggestions::Suggestions(std::vector<std::string>& output)
+    : output{output}
+{
+}
+
+
+void WordChecker::Suggestions::add(const std::string& candidate)
+{
+    // Keep the load factor at or below one half.
+    if((output.size() + 1) * 2 > slots.size())
+    {
+        grow();
+    }
+    std::size_t hash = std::hash<std::string>{}(candidate);
+    std::size_t mask = slots.size() - 1;
+    for(std::size_t i = hash & mask; ; i = (i + 1) & mask)
+    {
+        if(slots[i].index == EMPTY)
+        {
+            slots[i] = Slot{hash, int(output.size())};
+            output.push_back(candidate);
+            return;
+        }
+        if(slots[i].hash == hash && output[slots[i].index] == candidate)
+        {
+            return;
+        }
+    }
+}
+
+
+void WordChecker::Suggestions::grow()
+{
+    std::size_t newSize = slots.empty() ? INITIAL_SLOTS : slots.size() * 2;
+    std::vector<Slot> old{std::move(slots)};
+    slots.assign(newSize, Slot{0, EMPTY});
+    std::size_t mask = newSize - 1;
+    for(const Slot& slot : old)
+    {
+        if(slot.index != EMPTY)
+        {
+            std::size_t i = slot.hash & mask;
+            while(slots[i].index != EMPTY)
+            {
+                i = (i + 1) & mask;
+            }
+            slots[i] = slot;
+        }
+    }
+}
+
+
 
 
 WordChecker::WordChecker(const Set<std::string>& words)
-    : words{words}
+    : WordChecker{words, Alphabet::UppercaseAscii}
+{
+}
+
+
+WordChecker::WordChecker(const Set<std::string>& words, Alphabet alphabet)
+    : words{words}, alphabet{alphabet}, utf8{encodesUtf8(alphabet)}, trie{dynamic_cast<const TrieSet*>(&words)},
+      deletionIndex{dynamic_cast<const DeletionIndex*>(&words)},
+      lengthBucketIndex{dynamic_cast<const LengthBucketIndex*>(&words)},
+      lookup{dynamic_cast<const StringLookup*>(&words)},
+      pool{nullptr}, parallelMinimumLength{0}, cache{nullptr}, maxFrequency{0}
 {
 }
 
@@ -22,153 +166,1073 @@ bool WordChecker::wordExists(const std::string& word) const
 }
 
 
+bool WordChecker::probe(SuggestionStrategy strategy, const std::string& candidate) const
+{
+    countProbe(strategy);
+    bool found = wordExists(candidate);
+    if(found)
+    {
+        countHit(strategy);
+    }
+    return found;
+}
+
+
+bool WordChecker::wordExists(std::string_view word, std::string& scratch) const
+{
+    if(lookup != nullptr)
+    {
+        return lookup->containsView(word);
+    }
+    scratch.assign(word);
+    return words.contains(scratch);
+}
+
+
+bool WordChecker::probe(SuggestionStrategy strategy, std::string_view candidate, std::string& scratch) const
+{
+    countProbe(strategy);
+    bool found = wordExists(candidate, scratch);
+    if(found)
+    {
+        countHit(strategy);
+    }
+    return found;
+}
+
+
 std::vector<std::string> WordChecker::findSuggestions(const std::string& word) const
 {
-    // Nonsensical code because the compiler requires the member variables
-    // 'words' to be used somewhere, or else it becomes a warning (which
-    // turns into an error).
+    if(cache == nullptr)
+    {
+        return generateAll(word);
+    }
+
+    // The generation is read once, so that suggestions generated while a
+    // word is being added are stored under the generation they were looked
+    // up with, which the add() has already made stale, rather than the new
+    // one.
+    unsigned long generation = words.size();
     std::vector<std::string> result;
-    std::vector<std::string> wordFromSwap = swapAdjacent(word);
-    std::vector<std::string> wordFromInsert = insertAdjacent(word);
-    std::vector<std::string> wordFromDelete = deleteCharacter(word);
-    std::vector<std::string> wordFromReplace = replaceCharacter(word);
-    std::vector<std::string> wordFromSplit = splitAdjacent(word);
-    for(int i = 0; i < wordFromSwap.size(); i++)
+    if(!cache->find(word, generation, result))
+    {
+        result = generateAll(word);
+        cache->insert(word, generation, result);
+    }
+    return result;
+}
+
+
+std::vector<std::string> WordChecker::findSuggestions(const std::string& word, const CancellationToken& token) const
+{
+    unsigned long generation = words.size();
+    std::vector<std::string> result;
+    if(cache != nullptr && cache->find(word, generation, result))
+    {
+        return result;
+    }
+    result = generateInSteps(word, token);
+    if(cache != nullptr)
+    {
+        cache->insert(word, generation, result);
+    }
+    return result;
+}
+
+
+std::vector<std::string> WordChecker::generateAll(const std::string& word) const
+{
+    if(pool != nullptr && word.length() >= parallelMinimumLength)
+    {
+        return findSuggestionsInParallel(word);
+    }
+
+    std::vector<std::string> output;
+    Suggestions result{output};
+
+    // One edit buffer, large enough for the longest candidate (an insert),
+    // is shared by every generator.
+    std::string buffer;
+    buffer.reserve(word.length() + 1);
+
+    generateSuggestions(word, buffer, result);
+    return output;
+}
+
+
+std::vector<std::string> WordChecker::generateInSteps(const std::string& word, const CancellationToken& token) const
+{
+    // The generators run in the same order as in generateSuggestions(), but
+    // those that probe a whole alphabet per position run one position at a
+    // time, so that no step between checks of the token takes long.
+    std::vector<std::string> output;
+    Suggestions result{output};
+    std::string buffer;
+    buffer.reserve(word.length() + 1);
+
+    token.throwIfCancelled();
+    swapAdjacent(word, buffer, result);
+    for(std::size_t i = 0; i <= word.length(); i++)
+    {
+        token.throwIfCancelled();
+        insertAdjacent(word, i, i + 1, buffer, result);
+    }
+    token.throwIfCancelled();
+    deleteCharacter(word, buffer, result);
+    for(std::size_t i = 0; i < word.length(); i++)
+    {
+        token.throwIfCancelled();
+        replaceCharacter(word, i, i + 1, buffer, result);
+    }
+    token.throwIfCancelled();
+    splitAdjacent(word, buffer, result);
+    return output;
+}
+
+
+std::vector<std::string> WordChecker::findLikelySuggestions(const std::string& word, std::size_t limit) const
+{
+    return findLikelySuggestions(word, limit, KeyboardLayout::qwerty());
+}
+
+
+std::vector<std::string> WordChecker::findLikelySuggestions(
+    const std::string& word, std::size_t limit, const KeyboardLayout& layout) const
+{
+    std::string_view letters = withAlphabet(alphabet, [](auto policy) { return decltype(policy)::letters; });
+    if(utf8 && !(isAscii(word) && isAscii(letters)))
+    {
+        std::vector<std::string> all = findSuggestions(word);
+        all.resize(std::min(all.size(), limit));
+        return all;
+    }
+
+    std::vector<std::string> output;
+    Suggestions result{output};
+    std::string buffer;
+    buffer.reserve(word.length() + 1);
+    auto done = [&]() { return output.size() >= limit; };
+
+    // editAt() applies one kind of edit at position i, with the given
+    // letters in the given order, until enough suggestions are found.
+    std::vector<std::string> found;
+    auto editAt = [&](TrieEdit edit, std::size_t i, std::string_view with)
+    {
+        if(trie != nullptr)
+        {
+            // findEdits() visits the candidates in the trie's order, so
+            // they're put back into the order of the letters first, which
+            // is the order in which probing would find them.  A probe is
+            // counted for each candidate that probing would have tried (one
+            // per letter, or just one for a swap or deletion), so that the
+            // counters match those of the Set path.
+            found.clear();
+            trie->findEdits(word, edit, i, i + 1, with, [&](const std::string& candidate)
+            {
+                found.push_back(candidate);
+            });
+            bool perLetter = edit == TrieEdit::Insert || edit == TrieEdit::Replace;
+            if(perLetter)
+            {
+                std::stable_sort(found.begin(), found.end(), [&](const std::string& a, const std::string& b)
+                {
+                    return with.find(a[i]) < with.find(b[i]);
+                });
+            }
+            std::size_t next = 0;
+            for(std::size_t l = 0; l < (perLetter ? with.length() : 1) && !done(); l++)
+            {
+                countProbe(strategyOf(edit));
+                while(next < found.size() && !done() && (!perLetter || found[next][i] == with[l]))
+                {
+                    countHit(strategyOf(edit));
+                    result.add(found[next++]);
+                }
+            }
+            return;
+        }
+
+        auto tryBuffer = [&]()
+        {
+            if(!done() && probe(strategyOf(edit), buffer))
+            {
+                result.add(buffer);
+            }
+        };
+        switch(edit)
+        {
+        case TrieEdit::Swap:
+            buffer.assign(word);
+            std::swap(buffer[i], buffer[i + 1]);
+            tryBuffer();
+            break;
+
+        case TrieEdit::Delete:
+            buffer.assign(word).erase(i, 1);
+            tryBuffer();
+            break;
+
+        case TrieEdit::Insert:
+            buffer.assign(word).insert(i, 1, ' ');
+            for(std::size_t l = 0; l < with.length() && !done(); l++)
+            {
+                buffer[i] = with[l];
+                tryBuffer();
+            }
+            break;
+
+        case TrieEdit::Replace:
+            buffer.assign(word);
+            for(std::size_t l = 0; l < with.length() && !done(); l++)
+            {
+                buffer[i] = with[l];
+                tryBuffer();
+            }
+            break;
+        }
+    };
+
+    bool isLetter[256] = {};
+    for(char letter : letters)
+    {
+        isLetter[static_cast<unsigned char>(letter)] = true;
+    }
+
+    // lettersAt() returns the letters of the alphabet likeliest to have been
+    // meant at position i (near), likeliest first, or the rest of them (far),
+    // in the alphabet's order.  The likeliest letters are, for a replacement,
+    // the keyboard neighbors of the character there, and for an insertion,
+    // the characters on either side, then their neighbors.
+    std::size_t n = word.length();
+    std::string likely;
+    std::string with;
+    auto lettersAt = [&](TrieEdit edit, std::size_t i, bool near) -> std::string_view
+    {
+        likely.clear();
+        if(edit == TrieEdit::Replace)
+        {
+            likely.append(layout.neighbors(word[i]));
+        }
+        else
+        {
+            if(i > 0)
+            {
+                likely.push_back(word[i - 1]);
+            }
+            if(i < n)
+            {
+                likely.push_back(word[i]);
+            }
+            if(i > 0)
+            {
+                likely.append(layout.neighbors(word[i - 1]));
+            }
+            if(i < n)
+            {
+                likely.append(layout.neighbors(word[i]));
+            }
+        }
+
+        bool isLikely[256] = {};
+        with.clear();
+        for(char letter : likely)
+        {
+            unsigned char u = static_cast<unsigned char>(letter);
+            if(isLetter[u] && !isLikely[u])
+            {
+                isLikely[u] = true;
+                if(near)
+                {
+                    with.push_back(letter);
+                }
+            }
+        }
+        for(char letter : letters)
+        {
+            if(!near && !isLikely[static_cast<unsigned char>(letter)])
+            {
+                with.push_back(letter);
+            }
+        }
+        return with;
+    };
+
+    for(std::size_t i = 0; i + 1 < n && !done(); i++)
+    {
+        editAt(TrieEdit::Swap, i, {});
+    }
+    for(std::size_t i = 0; i < n && !done(); i++)
+    {
+        editAt(TrieEdit::Replace, i, lettersAt(TrieEdit::Replace, i, true));
+    }
+    for(std::size_t i = 0; i < n && !done(); i++)
+    {
+        editAt(TrieEdit::Delete, i, {});
+    }
+    for(std::size_t i = 0; i <= n && !done(); i++)
+    {
+        editAt(TrieEdit::Insert, i, lettersAt(TrieEdit::Insert, i, true));
+    }
+    for(std::size_t i = 0; i < n && !done(); i++)
+    {
+        editAt(TrieEdit::Replace, i, lettersAt(TrieEdit::Replace, i, false));
+    }
+    for(std::size_t i = 0; i <= n && !done(); i++)
+    {
+        editAt(TrieEdit::Insert, i, lettersAt(TrieEdit::Insert, i, false));
+    }
+    if(!done())
+    {
+        splitAdjacent(word, buffer, result);
+        output.resize(std::min(output.size(), limit));
+    }
+    return output;
+}
+
+
+std::vector<std::string> WordChecker::findSegmentation(const std::string& text) const
+{
+    // fewest[i] is the fewest words into which text[i..) can be divided, and
+    // next[i] where the first of them ends; both are filled in from the end
+    // of the text backward, so each position's answer is ready by the time
+    // an earlier one needs it.
+    constexpr std::size_t NONE = static_cast<std::size_t>(-1);
+    std::size_t n = text.length();
+    std::vector<std::size_t> fewest(n + 1, NONE);
+    std::vector<std::size_t> next(n + 1, NONE);
+    fewest[n] = 0;
+
+    std::vector<std::size_t> lengths;
+    std::string buffer;
+    for(std::size_t i = n; i-- > 0; )
+    {
+        lengths.clear();
+        if(trie != nullptr)
+        {
+            trie->prefixLengths(std::string_view{text}.substr(i), lengths);
+        }
+        else
+        {
+            for(std::size_t length = 1; i + length <= n; length++)
+            {
+                if(wordExists(std::string_view{text}.substr(i, length), buffer))
+                {
+                    lengths.push_back(length);
+                }
+            }
+        }
+
+        // Longest first, so that ties go to the longest word.
+        for(auto length = lengths.rbegin(); length != lengths.rend() && *length > 0; ++length)
+        {
+            std::size_t j = i + *length;
+            if(fewest[j] != NONE && (fewest[i] == NONE || fewest[j] + 1 < fewest[i]))
+            {
+                fewest[i] = fewest[j] + 1;
+                next[i] = j;
+            }
+        }
+    }
+
+    std::vector<std::string> segmentation;
+    if(n == 0 || fewest[0] == NONE)
+    {
+        return segmentation;
+    }
+    segmentation.reserve(fewest[0]);
+    for(std::size_t i = 0; i < n; i = next[i])
+    {
+        segmentation.emplace_back(text, i, next[i] - i);
+    }
+    return segmentation;
+}
+
+
+void WordChecker::setFrequency(const std::string& word, unsigned long frequency)
+{
+    frequencies[word] = frequency;
+    maxFrequency = std::max(maxFrequency, frequency);
+}
+
+
+std::vector<std::string> WordChecker::findTopSuggestions(const std::string& word, std::size_t k) const
+{
+    using Generator = std::function<void(std::string&, Suggestions&)>;
+
+    struct Strategy
+    {
+        double weight;
+        Generator generate;
+    };
+
+    // Ranked by how common each kind of typo is; this must stay in
+    // decreasing order of weight for the early exit below to be correct.
+    const Strategy strategies[] = {
+        {1.0, [&](std::string& b, Suggestions& r) { swapAdjacent(word, b, r); }},
+        {0.9, [&](std::string& b, Suggestions& r) { replaceCharacter(word, 0, word.length(), b, r); }},
+        {0.8, [&](std::string& b, Suggestions& r) { deleteCharacter(word, b, r); }},
+        {0.8, [&](std::string& b, Suggestions& r) { insertAdjacent(word, 0, word.length() + 1, b, r); }},
+        {0.5, [&](std::string& b, Suggestions& r) { splitAdjacent(word, b, r); }}
+    };
+
+    struct Candidate
+    {
+        double score;
+        std::size_t order;
+        std::string word;
+    };
+
+    // "best" is a heap ordered so that its front is the worst candidate kept
+    // so far: the lowest score, or among equal scores, the one found last.
+    auto better = [](const Candidate& a, const Candidate& b)
+    {
+        return a.score != b.score ? a.score > b.score : a.order < b.order;
+    };
+    std::vector<Candidate> best;
+    best.reserve(k);
+
+    std::unordered_set<std::string> seen;
+    std::size_t order = 0;
+    std::string buffer;
+    buffer.reserve(word.length() + 1);
+    std::vector<std::string> hits;
+
+    for(const Strategy& strategy : strategies)
     {
-        std::vector<std::string>::iterator s;
-        s = std::find(result.begin(), result.end(), wordFromSwap[i]);
-        if(s == result.end())
+        if(k == 0 || (best.size() == k && best.front().score >= (maxFrequency + 1.0) * strategy.weight))
+        {
+            break;
+        }
+
+        hits.clear();
+        Suggestions result{hits};
+        strategy.generate(buffer, result);
+
+        for(std::string& hit : hits)
         {
-            result.push_back(wordFromSwap[i]);
+            // Strategies run best first, so a word's first score is its best.
+            if(!seen.insert(hit).second)
+            {
+                continue;
+            }
+            auto frequency = frequencies.find(hit);
+            double score = ((frequency != frequencies.end() ? frequency->second : 0) + 1.0) * strategy.weight;
+            if(best.size() < k)
+            {
+                best.push_back(Candidate{score, order++, std::move(hit)});
+                std::push_heap(best.begin(), best.end(), better);
+            }
+            else if(score > best.front().score)
+            {
+                std::pop_heap(best.begin(), best.end(), better);
+                best.back() = Candidate{score, order++, std::move(hit)};
+                std::push_heap(best.begin(), best.end(), better);
+            }
         }
     }
-    for(int i = 0; i < wordFromInsert.size(); i++)
+
+    std::sort(best.begin(), best.end(), better);
+    std::vector<std::string> result;
+    result.reserve(best.size());
+    for(Candidate& candidate : best)
+    {
+        result.push_back(std::move(candidate.word));
+    }
+    return result;
+}
+
+
+void WordChecker::useDeletionIndex(const DeletionIndex& index)
+{
+    deletionIndex = &index;
+}
+
+
+std::vector<std::string> WordChecker::findSuggestionsWithin(const std::string& word, unsigned int maxDistance) const
+{
+    return findSuggestionsWithin(word, maxDistance, SuggestionEngine::Deletions);
+}
+
+
+void WordChecker::useLengthBucketIndex(const LengthBucketIndex& index)
+{
+    lengthBucketIndex = &index;
+}
+
+
+std::vector<std::string> WordChecker::findSuggestionsWithin(
+    const std::string& word, unsigned int maxDistance, SuggestionEngine engine) const
+{
+    if(engine == SuggestionEngine::LengthBuckets && lengthBucketIndex != nullptr)
+    {
+        return lengthBucketIndex->findSuggestions(word, maxDistance);
+    }
+    if(engine == SuggestionEngine::Deletions && deletionIndex != nullptr)
+    {
+        return deletionIndex->findSuggestions(word, maxDistance);
+    }
+    return findSuggestions(word);
+}
+
+
+std::vector<std::string> WordChecker::findSuggestionsWithin(
+    const std::string& word, unsigned int maxDistance, SuggestionEngine engine,
+    const CancellationToken& token) const
+{
+    if(engine == SuggestionEngine::LengthBuckets && lengthBucketIndex != nullptr)
+    {
+        return lengthBucketIndex->findSuggestions(word, maxDistance, token);
+    }
+    if(engine == SuggestionEngine::Deletions && deletionIndex != nullptr)
     {
-        std::vector<std::string>::iterator s;
-        s = std::find(result.begin(), result.end(), wordFromInsert[i]);
-        if(s == result.end())
+        return deletionIndex->findSuggestions(word, maxDistance, token);
+    }
+    return findSuggestions(word, token);
+}
+
+
+void WordChecker::enableParallelSuggestions(ThreadPool& pool, std::size_t minimumLength)
+{
+    this->pool = &pool;
+    parallelMinimumLength = minimumLength;
+}
+
+
+void WordChecker::disableParallelSuggestions() noexcept
+{
+    pool = nullptr;
+}
+
+
+void WordChecker::useSuggestionCache(SuggestionCache& cache)
+{
+    this->cache = &cache;
+}
+
+
+std::vector<std::string> WordChecker::findSuggestionsInParallel(const std::string& word) const
+{
+    // The work is cut into parts, each run as a task with its own buffer and
+    // its own output.  Listing the parts in the order in which the generators
+    // run sequentially, then merging their outputs in that same order, gives
+    // exactly the sequential result.  insertAdjacent() and replaceCharacter()
+    // probe 26 candidates per position, so they're further divided into
+    // ranges of positions, one per worker thread.
+    using Part = std::function<void(std::string&, Suggestions&)>;
+    using RangeGenerator = void (WordChecker::*)(const std::string&, std::size_t, std::size_t,
+                                                 std::string&, Suggestions&) const;
+
+    std::vector<Part> parts;
+    std::size_t chunks = pool->threadCount();
+    auto addRanges = [&](RangeGenerator generator, std::size_t positions)
+    {
+        for(std::size_t c = 0; c < chunks; c++)
         {
-            result.push_back(wordFromInsert[i]);
+            std::size_t first = positions * c / chunks;
+            std::size_t last = positions * (c + 1) / chunks;
+            if(first < last)
+            {
+                parts.push_back([this, &word, generator, first, last](std::string& buffer, Suggestions& result)
+                {
+                    (this->*generator)(word, first, last, buffer, result);
+                });
+            }
         }
+    };
+
+    parts.push_back([this, &word](std::string& buffer, Suggestions& result) { swapAdjacent(word, buffer, result); });
+    addRanges(&WordChecker::insertAdjacent, word.length() + 1);
+    parts.push_back([this, &word](std::string& buffer, Suggestions& result) { deleteCharacter(word, buffer, result); });
+    addRanges(&WordChecker::replaceCharacter, word.length());
+    parts.push_back([this, &word](std::string& buffer, Suggestions& result) { splitAdjacent(word, buffer, result); });
+
+    std::vector<std::vector<std::string>> outputs(parts.size());
+    std::vector<std::future<void>> finished;
+    finished.reserve(parts.size());
+    for(std::size_t i = 0; i < parts.size(); i++)
+    {
+        finished.push_back(pool->submit([&word, &parts, &outputs, i]()
+        {
+            std::string buffer;
+            buffer.reserve(word.length() + 1);
+            Suggestions result{outputs[i]};
+            parts[i](buffer, result);
+        }));
     }
-    for(int i = 0; i < wordFromDelete.size(); i++)
+
+    // Every task refers to this function's locals, so all of them have to
+    // finish before an exception from any one of them can be rethrown.
+    for(std::future<void>& f : finished)
+    {
+        f.wait();
+    }
+    for(std::future<void>& f : finished)
     {
-        std::vector<std::string>::iterator s;
-        s = std::find(result.begin(), result.end(), wordFromDelete[i]);
-        if(s == result.end())
+        f.get();
+    }
+
+    std::vector<std::string> output;
+    Suggestions result{output};
+    for(const std::vector<std::string>& part : outputs)
+    {
+        for(const std::string& suggestion : part)
         {
-            result.push_back(wordFromDelete[i]);
+            result.add(suggestion);
         }
     }
-    for(int i = 0; i < wordFromReplace.size(); i++)
+    return output;
+}
+
+
+namespace
+{
+    // The batch functions accept words either as strings or as views into
+    // a caller's text.  Suggestions are generated from a string, so views
+    // are copied into a scratch buffer, which is reused.
+
+    const std::string& asString(const std::string& word, std::string&)
     {
-        std::vector<std::string>::iterator s;
-        s = std::find(result.begin(), result.end(), wordFromReplace[i]);
-        if(s == result.end())
+        return word;
+    }
+
+
+    const std::string& asString(std::string_view word, std::string& scratch)
+    {
+        scratch.assign(word);
+        return scratch;
+    }
+
+
+    // checkBatch() looks up each distinct word in the batch once, with the
+    // given function.
+    template <typename Word, typename Exists>
+    std::vector<bool> checkBatch(const std::vector<Word>& batch, Exists exists)
+    {
+        std::vector<bool> misspelled(batch.size());
+        std::unordered_map<std::string_view, bool> seen;
+        seen.reserve(batch.size());
+        for(std::size_t i = 0; i < batch.size(); i++)
         {
-            result.push_back(wordFromReplace[i]);
+            auto found = seen.find(std::string_view{batch[i]});
+            if(found == seen.end())
+            {
+                bool miss = !exists(batch[i]);
+                found = seen.emplace(std::string_view{batch[i]}, miss).first;
+            }
+            misspelled[i] = found->second;
         }
+        return misspelled;
     }
-    for(int i = 0; i < wordFromSplit.size(); i++)
+}
+
+
+std::vector<bool> WordChecker::checkWords(const std::vector<std::string>& batch) const
+{
+    return checkBatch(batch, [this](const std::string& word) { return words.contains(word); });
+}
+
+
+std::vector<bool> WordChecker::checkWords(const std::vector<std::string_view>& batch) const
+{
+    std::string scratch;
+    return checkBatch(batch, [this, &scratch](std::string_view word) { return wordExists(word, scratch); });
+}
+
+
+template <typename Word>
+std::vector<std::vector<std::string>> WordChecker::suggestBatch(
+    const std::vector<Word>& batch, const std::vector<bool>& misspelled) const
+{
+    std::vector<std::vector<std::string>> result(batch.size());
+    std::unordered_map<std::string_view, std::size_t> firstSeen;
+    std::string scratch;
+    std::string buffer;
+    for(std::size_t i = 0; i < batch.size() && i < misspelled.size(); i++)
     {
-        std::vector<std::string>::iterator s;
-        s = std::find(result.begin(), result.end(), wordFromSplit[i]);
-        if(s == result.end())
+        if(!misspelled[i])
+        {
+            continue;
+        }
+        auto found = firstSeen.find(std::string_view{batch[i]});
+        if(found != firstSeen.end())
         {
-            result.push_back(wordFromSplit[i]);
+            result[i] = result[found->second];
+            continue;
         }
+        firstSeen.emplace(std::string_view{batch[i]}, i);
+        Suggestions suggestions{result[i]};
+        generateSuggestions(asString(batch[i], scratch), buffer, suggestions);
     }
     return result;
 }
 
-std::vector<std::string> WordChecker::swapAdjacent(const std::string& word) const
+
+std::vector<std::vector<std::string>> WordChecker::findSuggestions(
+    const std::vector<std::string>& batch, const std::vector<bool>& misspelled) const
 {
-    std::vector<std::string> result;
-    for(int i = 0; i < word.length() - 1; i++)
+    return suggestBatch(batch, misspelled);
+}
+
+
+std::vector<std::vector<std::string>> WordChecker::findSuggestions(
+    const std::vector<std::string_view>& batch, const std::vector<bool>& misspelled) const
+{
+    return suggestBatch(batch, misspelled);
+}
+
+
+void WordChecker::generateSuggestions(const std::string& word, std::string& buffer, Suggestions& result) const
+{
+    swapAdjacent(word, buffer, result);
+    insertAdjacent(word, 0, word.length() + 1, buffer, result);
+    deleteCharacter(word, buffer, result);
+    replaceCharacter(word, 0, word.length(), buffer, result);
+    splitAdjacent(word, buffer, result);
+}
+
+void WordChecker::swapAdjacent(const std::string& word, std::string& buffer, Suggestions& result) const
+{
+    if(editsCodePoints(word))
     {
-        std::string temp = word.substr(0, i) + word.at(i + 1) + word.at(i) + word.substr(i + 2, word.length() - i - 2);
-        if(wordExists(temp))
+        swapCodePoints(word, buffer, result);
+        return;
+    }
+    if(trie != nullptr)
+    {
+        trie->findEdits(word, TrieEdit::Swap, 0, word.length(), {},
+                        [&result](const std::string& candidate)
+                        {
+                            countHit(SuggestionStrategy::Swap);
+                            result.add(candidate);
+                        });
+        return;
+    }
+
+    buffer.assign(word);
+    for(std::size_t i = 0; i + 1 < buffer.length(); i++)
+    {
+        std::swap(buffer[i], buffer[i + 1]);
+        if(probe(SuggestionStrategy::Swap, buffer))
         {
-            result.push_back(temp);
+            result.add(buffer);
         }
+        std::swap(buffer[i], buffer[i + 1]);
     }
-    return result;
 }
 
-std::vector<std::string> WordChecker::insertAdjacent(const std::string& word) const
+void WordChecker::insertAdjacent(const std::string& word, std::size_t first, std::size_t last,
+                                 std::string& buffer, Suggestions& result) const
 {
-    std::vector<std::string> letter = {"A", "B", "C", "D", "E", "F", "G", "H", "I", "J", "K", "L", 
-                                       "M", "N", "O", "P", "Q", "R", "S", "T", "U", "V", "W", "X", 
-                                       "Y", "Z"};
-    std::vector<std::string> result;
-    for(int i = 0; i < word.length(); i++)
+    withAlphabet(alphabet, [&](auto letters)
     {
-        for(int j = 0; j < 26; j++)
+        insertLetters<decltype(letters)>(word, first, last, buffer, result);
+    });
+}
+
+template <typename Letters>
+void WordChecker::insertLetters(const std::string& word, std::size_t first, std::size_t last,
+                                std::string& buffer, Suggestions& result) const
+{
+    // Letters beyond ASCII take more than one byte in UTF-8, so they can't
+    // be inserted by the byte path, whatever the word.
+    if constexpr(Letters::utf8)
+    {
+        if(!hasOnlyAsciiLetters<Letters>() || !isAscii(word))
+        {
+            insertCodePoints<Letters>(word, first, last, buffer, result);
+            return;
+        }
+    }
+    if(trie != nullptr)
+    {
+        trie->findEdits(word, TrieEdit::Insert, first, last, Letters::letters,
+                        [&result](const std::string& candidate)
+                        {
+                            countHit(SuggestionStrategy::Insert);
+                            result.add(candidate);
+                        });
+        return;
+    }
+
+    // The buffer holds the word with a one-character gap at position i; the
+    // gap is filled with each letter in turn, then moved one place right by
+    // copying the next original character into it.
+    buffer.assign(word, 0, first);
+    buffer.append(1, ' ');
+    buffer.append(word, first, std::string::npos);
+    for(std::size_t i = first; i < last && i <= word.length(); i++)
+    {
+        forEachLetter<Letters>([&](char letter)
         {
-            std::string temp = word.substr(0, i) + letter[j] + word.substr(i, word.length() - i);
-            if(wordExists(temp))
+            buffer[i] = letter;
+            if(probe(SuggestionStrategy::Insert, buffer))
             {
-                result.push_back(temp);
+                result.add(buffer);
             }
+        });
+        if(i < word.length())
+        {
+            buffer[i] = word[i];
         }
     }
-    for(int j = 0; j < 26; j++)
+}
+
+void WordChecker::deleteCharacter(const std::string& word, std::string& buffer, Suggestions& result) const
+{
+    if(editsCodePoints(word))
+    {
+        deleteCodePoint(word, buffer, result);
+        return;
+    }
+    if(trie != nullptr)
+    {
+        trie->findEdits(word, TrieEdit::Delete, 0, word.length(), {},
+                        [&result](const std::string& candidate)
+                        {
+                            countHit(SuggestionStrategy::Delete);
+                            result.add(candidate);
+                        });
+        return;
+    }
+
+    // The buffer holds the word with character i removed; moving on to i + 1
+    // only requires putting character i back in its place.
+    if(word.empty())
+    {
+        return;
+    }
+    buffer.assign(word, 1, std::string::npos);
+    for(std::size_t i = 0; i < word.length(); i++)
     {
-        std::string temp = word + letter[j];
-        if(wordExists(temp))
+        if(i > 0)
+        {
+            buffer[i - 1] = word[i - 1];
+        }
+        if(probe(SuggestionStrategy::Delete, buffer))
         {
-            result.push_back(temp);
+            result.add(buffer);
         }
     }
-    return result;
 }
 
-std::vector<std::string> WordChecker::deleteCharacter(const std::string& word) const
+void WordChecker::replaceCharacter(const std::string& word, std::size_t first, std::size_t last,
+                                   std::string& buffer, Suggestions& result) const
 {
-    std::vector<std::string> result;
-    for(int i = 0; i < word.length(); i++)
+    withAlphabet(alphabet, [&](auto letters)
+    {
+        replaceLetters<decltype(letters)>(word, first, last, buffer, result);
+    });
+}
+
+template <typename Letters>
+void WordChecker::replaceLetters(const std::string& word, std::size_t first, std::size_t last,
+                                 std::string& buffer, Suggestions& result) const
+{
+    if constexpr(Letters::utf8)
     {
-        std::string temp = word.substr(0, i) + word.substr(i + 1, word.length() - i - 1);
-        if(wordExists(temp))
+        if(!hasOnlyAsciiLetters<Letters>() || !isAscii(word))
         {
-            result.push_back(temp);
+            replaceCodePoints<Letters>(word, first, last, buffer, result);
+            return;
         }
     }
-    return result;
+    if(trie != nullptr)
+    {
+        trie->findEdits(word, TrieEdit::Replace, first, last, Letters::letters,
+                        [&result](const std::string& candidate)
+                        {
+                            countHit(SuggestionStrategy::Replace);
+                            result.add(candidate);
+                        });
+        return;
+    }
+
+    buffer.assign(word);
+    for(std::size_t i = first; i < last && i < word.length(); i++)
+    {
+        forEachLetter<Letters>([&](char letter)
+        {
+            buffer[i] = letter;
+            if(probe(SuggestionStrategy::Replace, buffer))
+            {
+                result.add(buffer);
+            }
+        });
+        buffer[i] = word[i];
+    }
 }
 
-std::vector<std::string> WordChecker::replaceCharacter(const std::string& word) const
+void WordChecker::splitAdjacent(const std::string& word, std::string& buffer, Suggestions& result) const
 {
-    std::vector<std::string> letter = {"A", "B", "C", "D", "E", "F", "G", "H", "I", "J", "K", "L", 
-                                       "M", "N", "O", "P", "Q", "R", "S", "T", "U", "V", "W", "X", 
-                                       "Y", "Z"};
-    std::vector<std::string> result;
-    for(int i = 0; i < word.length(); i++)
+    if(trie != nullptr)
     {
-        for(int j = 0; j < 26; j++)
+        // The prefix lengths come out increasing, so the suffix lengths that
+        // complete them are decreasing; walking the suffix lengths backward
+        // intersects the two lists in one pass.  Without a suffix index,
+        // only the suffixes that follow a prefix are looked up.  As on the
+        // Set path, a probe is counted for each place the word could be
+        // split, and another for each suffix looked up.
+#if SPELLCHECK_STATS
+        for(std::size_t i = 0; i < word.length(); i++)
         {
-            std::string temp = word.substr(0, i) + letter[j] + word.substr(i + 1, word.length() - i - 1);
-            if(wordExists(temp))
+            if(!(utf8 && isContinuationByte(word[i])))
             {
-                result.push_back(temp);
+                countProbe(SuggestionStrategy::Split);
             }
         }
+#endif
+        std::vector<std::size_t> prefixes;
+        std::vector<std::size_t> suffixes;
+        trie->prefixLengths(word, prefixes);
+        if(trie->hasSuffixIndex())
+        {
+            trie->suffixLengths(word, suffixes);
+        }
+        auto suffix = suffixes.rbegin();
+        for(std::size_t i : prefixes)
+        {
+            if(i >= word.length())
+            {
+                break;
+            }
+            if(utf8 && isContinuationByte(word[i]))
+            {
+                continue;
+            }
+            bool found;
+            if(trie->hasSuffixIndex())
+            {
+                while(suffix != suffixes.rend() && *suffix > word.length() - i)
+                {
+                    ++suffix;
+                }
+                found = suffix != suffixes.rend() && *suffix == word.length() - i;
+                countProbe(SuggestionStrategy::Split);
+                if(found)
+                {
+                    countHit(SuggestionStrategy::Split);
+                }
+            }
+            else
+            {
+                found = probe(SuggestionStrategy::Split, std::string_view{word}.substr(i), buffer);
+            }
+            if(found)
+            {
+                buffer.assign(word, 0, i).append(1, ' ').append(word, i, std::string::npos);
+                result.add(buffer);
+            }
+        }
+        return;
+    }
+
+    for(std::size_t i = 0; i < word.length(); i++)
+    {
+        if(utf8 && isContinuationByte(word[i]))
+        {
+            continue;
+        }
+        countProbe(SuggestionStrategy::Split);
+        if(!wordExists(std::string_view{word}.substr(0, i), buffer))
+        {
+            continue;
+        }
+        if(probe(SuggestionStrategy::Split, std::string_view{word}.substr(i), buffer))
+        {
+            buffer.assign(word, 0, i).append(1, ' ').append(word, i, std::string::npos);
+            result.add(buffer);
+        }
     }
-    return result;
 }
 
-std::vector<std::string> WordChecker::splitAdjacent(const std::string& word) const
+bool WordChecker::editsCodePoints(const std::string& word) const
 {
-    std::vector<std::string> result;
-    for(int i = 0; i < word.length(); i++)
+    return utf8 && !isAscii(word);
+}
+
+void WordChecker::swapCodePoints(const std::string& word, std::string& buffer, Suggestions& result) const
+{
+    // The code points starting at i and j trade places by rotating the bytes
+    // from i up to the end of the second one.
+    buffer.assign(word);
+    for(std::size_t i = 0, j = nextCodePoint(word, 0); j < word.length(); )
     {
-        std::string temp0 = word.substr(0, i);
-        std::string temp1 = word.substr(i, word.length() - i);
-        if(wordExists(temp0) && wordExists(temp1))
+        std::size_t k = nextCodePoint(word, j);
+        std::rotate(buffer.begin() + i, buffer.begin() + j, buffer.begin() + k);
+        if(probe(SuggestionStrategy::Swap, buffer))
         {
-            std::string temp = temp0 + " " + temp1;
-            result.push_back(temp);
+            result.add(buffer);
         }
+        std::copy(word.begin() + i, word.begin() + k, buffer.begin() + i);
+        i = j;
+        j = k;
     }
-    return result;
-}
\ No newline at end of file
+}
+
+template <typename Letters>
+void WordChecker::insertCodePoints(const std::string& word, std::size_t first, std::size_t last,
+                                   std::string& buffer, Suggestions& result) const
+{
+    // As in insertLetters(), the buffer holds the word with a gap at position
+    // i, but the gap's width is that of the letter last put in it.
+    char letterBytes[2];
+    for(std::size_t i = first; i < last && i <= word.length(); i++)
+    {
+        if(i < word.length() && isContinuationByte(word[i]))
+        {
+            continue;
+        }
+        buffer.assign(word);
+        std::size_t width = 0;
+        forEachLetter<Letters>([&](char letter)
+        {
+            std::size_t letterWidth = encodeLatin1(letter, letterBytes);
+            buffer.replace(i, width, letterBytes, letterWidth);
+            width = letterWidth;
+            if(probe(SuggestionStrategy::Insert, buffer))
+            {
+                result.add(buffer);
+            }
+        });
+    }
+}
+
+void WordChecker::deleteCodePoint(const std::string& word, std::string& buffer, Suggestions& result) const
+{
+    for(std::size_t i = 0; i < word.length(); )
+    {
+        std::size_t j = nextCodePoint(word, i);
+        buffer.assign(word, 0, i).append(word, j, std::string::npos);
+        if(probe(SuggestionStrategy::Delete, buffer))
+        {
+            result.add(buffer);
+        }
+        i = j;
+    }
+}
+
+template <typename Letters>
+void WordChecker::replaceCodePoints(const std::string& word, std::size_t first, std::size_t last,
+                                    std::string& buffer, Suggestions& result) const
+{
+    char letterBytes[2];
+    for(std::size_t i = first; i < last && i < word.length(); i++)
+    {
+        if(isContinuationByte(word[i]))
+        {
+            continue;
+        }
+        buffer.assign(word);
+        std::size_t width = nextCodePoint(word, i) - i;
+        forEachLetter<Letters>([&](char letter)
+        {
+            std::size_t letterWidth = encodeLatin1(letter, letterBytes);
+            buffer.replace(i, width, letterBytes, letterWidth);
+            width = letterWidth;
+            if(probe(SuggestionStrategy::Replace, buffer))
+            {
+                result.add(buffer);
+            }
+        });
+    }
+}
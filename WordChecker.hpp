@@ -17,9 +17,35 @@
 #define WORDCHECKER_HPP
 
 #include <string>
+#include <string_view>
+#include <unordered_map>
 #include <vector>
+#include "Alphabet.hpp"
 #include "Set.hpp"
 
+class CancellationToken;
+class DeletionIndex;
+class KeyboardLayout;
+class LengthBucketIndex;
+class StringLookup;
+class SuggestionCache;
+class ThreadPool;
+class TrieSet;
+enum class SuggestionStrategy;
+
+
+
+// A SuggestionEngine is one of the ways in which findSuggestionsWithin()
+// can find the words within an edit distance of a misspelling.
+enum class SuggestionEngine
+{
+    // Look up the misspelling's deletion variants in a DeletionIndex.
+    Deletions,
+
+    // Scan the words of nearby lengths in a LengthBucketIndex.
+    LengthBuckets
+};
+
 
 
 class WordChecker
@@ -27,8 +53,18 @@ class WordChecker
 public:
     // The constructor requires a Set of words to be passed into it.  The
     // WordChecker will store a reference to a const Set, which it will use
-    // whenever it needs to look up a word.
+    // whenever it needs to look up a word.  When the Set is a TrieSet, the
+    // swap, insert, delete and replace suggestions are found by walking the
+    // trie (see TrieSet::findEdits()) instead of by probing each candidate,
+    // and the splits by intersecting the words that begin the word with those
+    // that end it (see TrieSet::prefixLengths() and suffixLengths()).
+    // The letters inserted and substituted by the suggestion generators are
+    // the uppercase ASCII letters, unless another alphabet is given.  When
+    // the alphabet's words are UTF-8 (see Alphabet.hpp), words containing
+    // anything beyond ASCII are edited one code point at a time, so no
+    // suggestion is ever an invalid UTF-8 sequence.
     WordChecker(const Set<std::string>& words);
+    WordChecker(const Set<std::string>& words, Alphabet alphabet);
 
 
     // wordExists() returns true if the given word is spelled correctly,
@@ -41,24 +77,238 @@ public:
     // the project write-up.
     std::vector<std::string> findSuggestions(const std::string& word) const;
 
+    // findSuggestions() with a CancellationToken returns the same
+    // suggestions, but checks the token between small steps of the work
+    // (e.g., the insertions at one position), throwing an OperationCancelled
+    // as soon as it finds it cancelled.  It always runs entirely on the
+    // calling thread, so it may be called from a ThreadPool's own threads.
+    std::vector<std::string> findSuggestions(const std::string& word, const CancellationToken& token) const;
+
+
+    // checkWords() checks a whole batch of words (e.g., every word of a
+    // document) and returns one flag per word, true where the word is
+    // misspelled.  Words that occur more than once in the batch are only
+    // looked up once.
+    std::vector<bool> checkWords(const std::vector<std::string>& batch) const;
+    std::vector<bool> checkWords(const std::vector<std::string_view>& batch) const;
+
+
+    // findSuggestions() on a batch returns one vector of suggestions per
+    // word, generating them only for the words flagged in "misspelled"
+    // (as returned by checkWords()); the other words get an empty vector.
+    // Suggestions for a repeated misspelling are only generated once.
+    std::vector<std::vector<std::string>> findSuggestions(
+        const std::vector<std::string>& batch, const std::vector<bool>& misspelled) const;
+    std::vector<std::vector<std::string>> findSuggestions(
+        const std::vector<std::string_view>& batch, const std::vector<bool>& misspelled) const;
+
+
+    // findLikelySuggestions() returns at most "limit" of the suggestions
+    // that findSuggestions() would return, trying the likeliest typos first
+    // and stopping as soon as it has found enough: swaps, then replacements
+    // by the keys next to each character on the given keyboard layout
+    // (QWERTY, if none is given), then deletions, then insertions of a
+    // doubled character or a key next to its neighbors, and only then the
+    // rest of the alphabet and the splits.  Words that are edited one code
+    // point at a time (see the constructor) aren't ordered this way; they get
+    // the first "limit" of findSuggestions() instead.
+    std::vector<std::string> findLikelySuggestions(const std::string& word, std::size_t limit) const;
+    std::vector<std::string> findLikelySuggestions(
+        const std::string& word, std::size_t limit, const KeyboardLayout& layout) const;
+
+
+    // findSegmentation() divides the given text, such as words that were
+    // run together ("THEQUICKFOX"), into words in the Set, returning them in
+    // order, or an empty vector if it can't be done.  The division uses as
+    // few words as possible; among those that use equally few, the one whose
+    // first word is longest (then second, and so on) is chosen.  The best
+    // division of the text from each position on is worked out only once,
+    // so this takes at most one lookup per substring (and only one walk down
+    // the trie per position, when the Set is a TrieSet).
+    std::vector<std::string> findSegmentation(const std::string& text) const;
+
+
+    // setFrequency() records how often the given word occurs (e.g., in a
+    // corpus), which findTopSuggestions() uses to rank suggestions.  Words
+    // whose frequency is never set have a frequency of 0.
+    void setFrequency(const std::string& word, unsigned long frequency);
+
+
+    // findTopSuggestions() returns at most k of the suggestions that
+    // findSuggestions() would return, best first.  A suggestion's score is
+    // (frequency + 1) times a weight for the kind of edit that produced it,
+    // swaps counting most and splits least; ties go to the suggestion found
+    // first.  Each kind of edit is tried in decreasing order of weight, and
+    // once k suggestions are found, the kinds whose best possible score
+    // can't beat the k-th best found so far aren't tried at all.
+    std::vector<std::string> findTopSuggestions(const std::string& word, std::size_t k) const;
+
+
+    // useDeletionIndex() makes findSuggestionsWithin() look suggestions up
+    // in the given index, which must hold the same words as the Set and
+    // outlive the WordChecker.  When the Set passed to the constructor is
+    // itself a DeletionIndex, it is used this way automatically.
+    void useDeletionIndex(const DeletionIndex& index);
+
+
+    // findSuggestionsWithin() returns the words within the given edit
+    // distance of the given word, ordered by distance, then alphabetically,
+    // as found by the deletion index in use.  The distance is limited to the
+    // one the index was built for.  Without an index, reaching beyond one
+    // edit is too expensive, so this returns findSuggestions(word) instead.
+    std::vector<std::string> findSuggestionsWithin(const std::string& word, unsigned int maxDistance) const;
+
+
+    // useLengthBucketIndex() gives findSuggestionsWithin() a LengthBucketIndex
+    // to scan when it's asked to, under the same conditions as
+    // useDeletionIndex(); again, when the Set passed to the constructor is a
+    // LengthBucketIndex, it's used automatically.
+    void useLengthBucketIndex(const LengthBucketIndex& index);
+
+
+    // findSuggestionsWithin() with a SuggestionEngine finds the words within
+    // the given distance using that engine: the deletion index in use (as
+    // above), or a scan of the length bucket index in use, which costs more
+    // per lookup than a deletion index, but isn't limited in distance and
+    // needs little more memory than the words.  Either way, the suggestions
+    // are ordered by distance, then alphabetically, and without an index for
+    // the chosen engine, this returns findSuggestions(word) instead.
+    std::vector<std::string> findSuggestionsWithin(
+        const std::string& word, unsigned int maxDistance, SuggestionEngine engine) const;
+
+    // findSuggestionsWithin() with a CancellationToken is cancellable, as
+    // findSuggestions() is.
+    std::vector<std::string> findSuggestionsWithin(
+        const std::string& word, unsigned int maxDistance, SuggestionEngine engine,
+        const CancellationToken& token) const;
+
+
+    // enableParallelSuggestions() makes findSuggestions() divide the work
+    // for words of at least minimumLength characters into tasks run on the
+    // given pool; shorter words, for which the overhead isn't worth it, are
+    // still handled entirely on the calling thread.  The suggestions, and
+    // their order, are the same either way.  The pool must outlive the
+    // WordChecker (or be disabled first), and findSuggestions() must not be
+    // called from one of the pool's own threads, since it waits for its
+    // tasks to finish.
+    void enableParallelSuggestions(ThreadPool& pool, std::size_t minimumLength = 10);
+
+    // disableParallelSuggestions() returns findSuggestions() to running
+    // entirely on the calling thread.
+    void disableParallelSuggestions() noexcept;
+
+
+    // useSuggestionCache() makes findSuggestions() look for a word's
+    // suggestions in the given cache before generating them, and store them
+    // there afterward.  The cache may be shared by many WordCheckers on many
+    // threads, as long as they all check against the same Set with the same
+    // alphabet (the cache is keyed by word alone, and suggestions differ
+    // from one alphabet to another), and must outlive them.  Its entries are
+    // invalidated automatically when words are added to the Set.
+    void useSuggestionCache(SuggestionCache& cache);
+
 
 private:
     const Set<std::string>& words;
+    Alphabet alphabet;
+    bool utf8;
+    const TrieSet* trie;
+    const DeletionIndex* deletionIndex;
+    const LengthBucketIndex* lengthBucketIndex;
+    const StringLookup* lookup;
+    ThreadPool* pool;
+    std::size_t parallelMinimumLength;
+    SuggestionCache* cache;
+    std::unordered_map<std::string, unsigned long> frequencies;
+    unsigned long maxFrequency;
+
+    // Suggestions collects the hits of the helpers below into one output
+    // vector, dropping duplicates as they arrive while keeping the order in
+    // which they were first found.
+    class Suggestions;
+
+    // generateSuggestions() runs the five helpers below, in order, on one
+    // word, sharing the given edit buffer between them.
+    void generateSuggestions(const std::string& word, std::string& buffer, Suggestions& result) const;
+
+    // generateAll() generates the suggestions for one word, in parallel if
+    // parallel suggestions are enabled and the word is long enough; it's
+    // what findSuggestions() does when the word isn't in the cache.
+    std::vector<std::string> generateAll(const std::string& word) const;
+
+    // generateInSteps() is generateAll() for the cancellable
+    // findSuggestions(), on the calling thread.
+    std::vector<std::string> generateInSteps(const std::string& word, const CancellationToken& token) const;
+
+    // findSuggestionsInParallel() is generateAll() when parallel
+    // suggestions are enabled and the word is long enough.
+    std::vector<std::string> findSuggestionsInParallel(const std::string& word) const;
+
+    // suggestBatch() implements both batch versions of findSuggestions().
+    template <typename Word>
+    std::vector<std::vector<std::string>> suggestBatch(
+        const std::vector<Word>& batch, const std::vector<bool>& misspelled) const;
+
+    // probe() is wordExists(), as used by the helpers below, which also
+    // counts the probe (and hit) for the given strategy when statistics are
+    // kept (see Stats.hpp).
+    bool probe(SuggestionStrategy strategy, const std::string& candidate) const;
+
+    // These versions look up part of a larger string: straight from the
+    // view if the Set is a StringLookup, or else after copying it into the
+    // given scratch string.
+    bool wordExists(std::string_view word, std::string& scratch) const;
+    bool probe(SuggestionStrategy strategy, std::string_view candidate, std::string& scratch) const;
+
+    // Each helper below builds its candidates in the caller's edit buffer,
+    // changing it in place and restoring it after every probe, and adds each
+    // one that is a word to the caller's Suggestions.
 
     //Swapping each adjacent pair of characters in the word.
-    std::vector<std::string> swapAdjacent(const std::string& word) const;
+    void swapAdjacent(const std::string& word, std::string& buffer, Suggestions& result) const;
+
+    //In between each adjacent pair of characters in the word, insert each letter of the alphabet
+    //(at the insert positions in [first, last), where position i is just
+    //before character i and position word.length() is the end of the word).
+    void insertAdjacent(const std::string& word, std::size_t first, std::size_t last,
+                        std::string& buffer, Suggestions& result) const;
 
-    //In between each adjacent pair of characters in the word, insert 'A' to 'Z'
-    std::vector<std::string> insertAdjacent(const std::string& word) const;
+    template <typename Letters>
+    void insertLetters(const std::string& word, std::size_t first, std::size_t last,
+                       std::string& buffer, Suggestions& result) const;
 
     //Deleting each character from the word.
-    std::vector<std::string> deleteCharacter(const std::string& word) const;
+    void deleteCharacter(const std::string& word, std::string& buffer, Suggestions& result) const;
 
-    //Replacing each character in the word with each letter from 'A' through 'Z'.
-    std::vector<std::string> replaceCharacter(const std::string& word) const;
+    //Replacing each character in the word with each letter of the alphabet
+    //(for the characters at positions in [first, last)).
+    void replaceCharacter(const std::string& word, std::size_t first, std::size_t last,
+                          std::string& buffer, Suggestions& result) const;
+
+    template <typename Letters>
+    void replaceLetters(const std::string& word, std::size_t first, std::size_t last,
+                        std::string& buffer, Suggestions& result) const;
 
     //Splitting the word into a pair of words by adding a space in between each adjacent pair of characters in the word.
-    std::vector<std::string> splitAdjacent(const std::string& word) const;
+    void splitAdjacent(const std::string& word, std::string& buffer, Suggestions& result) const;
+
+    // The helpers below are the code point versions of the ones above, which
+    // take their place for words that aren't pure ASCII when the alphabet's
+    // words are UTF-8.  Their positions are still byte offsets; those that
+    // fall inside a code point are skipped.
+    bool editsCodePoints(const std::string& word) const;
+
+    void swapCodePoints(const std::string& word, std::string& buffer, Suggestions& result) const;
+
+    template <typename Letters>
+    void insertCodePoints(const std::string& word, std::size_t first, std::size_t last,
+                          std::string& buffer, Suggestions& result) const;
+
+    void deleteCodePoint(const std::string& word, std::string& buffer, Suggestions& result) const;
+
+    template <typename Letters>
+    void replaceCodePoints(const std::string& word, std::size_t first, std::size_t last,
+                           std::string& buffer, Suggestions& result) const;
 };
 
 
@@ -0,0 +1,713 @@
+// benchmark.cpp
+//
+// A command-line program that compares the Set implementations, and a
+// WordChecker using each of them, on a real word list:
+//
+//     benchmark WORDLIST [--words N] [--queries N] [--suggestions N]
+//                        [--seed N] [--sets NAME,NAME,...]
+//                        [--engines NAME,NAME,...]
+//
+// WORDLIST is a file of words, one per line, which are uppercased (as
+// spellcheck does) and added to each Set in a shuffled order, so that an
+// unbalanced AVLSet is a random binary search tree rather than a list.
+// --words limits how many of them are used (at least one), which keeps
+// the slower Sets' build times manageable.  For each Set, the program
+// measures:
+//
+//   * the time to build it
+//   * the memory it holds afterward, as counted by the global operator
+//     new and operator delete below (allocator overhead isn't included)
+//   * the latency of contains(), at the median and the 99th percentile,
+//     for --queries words in the Set ("hit") and as many that aren't
+//     ("miss"), each call timed separately
+//   * for a BloomFilterSet, the proportion of those misses that its filter
+//     fails to reject (its false positive rate)
+//   * how many misspellings per second findSuggestions() handles, for up
+//     to --suggestions misspellings each of short (at most 5 characters),
+//     medium (6 to 10) and long (11 or more) words, and the average time
+//     and number of allocations (counted by operator new, and including
+//     the vector of suggestions returned) per call
+//
+// The results are written to the standard output as one JSON object, so
+// that runs can be saved and compared over time.  --sets chooses which
+// Sets are measured, from hash, hash-function (a HashSet given a
+// HashFunction, hashing through std::function), flat, avl, avl-unbalanced,
+// skiplist, trie and bloom (a BloomFilterSet in front of a HashSet; all of
+// them, by default).
+//
+// --engines also measures the indexes behind findSuggestionsWithin(), which
+// trade memory for the speed of finding every word within edit distance 1
+// or 2 (none of them, by default): deletions (a DeletionIndex) and
+// length-buckets (a LengthBucketIndex).  For each,
+// the program measures the time to build it, the memory it holds, both as
+// counted by operator new and as estimated by its memoryUsage(), and the
+// latency of its findSuggestions() at distances 1 and 2, at the median and
+// the 99th percentile, for the same misspellings as findSuggestions().
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <new>
+#include <random>
+#include <sstream>
+#include <string>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+#include "AVLSet.hpp"
+#include "BloomFilterSet.hpp"
+#include "DeletionIndex.hpp"
+#include "FlatHashSet.hpp"
+#include "HashSet.hpp"
+#include "LengthBucketIndex.hpp"
+#include "SkipListSet.hpp"
+#include "TrieSet.hpp"
+#include "WordChecker.hpp"
+
+
+
+namespace
+{
+    // Every allocation is preceded by a header holding its size, so that
+    // the bytes currently allocated can be tracked as blocks are freed.
+    constexpr std::size_t HEADER_SIZE = alignof(std::max_align_t);
+
+    std::atomic<std::int64_t> allocatedBytes{0};
+
+    // The number of allocations ever made, so that the allocations made by
+    // a stretch of code can be counted.
+    std::atomic<std::uint64_t> allocationCount{0};
+}
+
+
+void* operator new(std::size_t size)
+{
+    void* block = std::malloc(size + HEADER_SIZE);
+    if(block == nullptr)
+    {
+        throw std::bad_alloc{};
+    }
+    *static_cast<std::size_t*>(block) = size;
+    allocatedBytes += size;
+    allocationCount.fetch_add(1, std::memory_order_relaxed);
+    return static_cast<char*>(block) + HEADER_SIZE;
+}
+
+
+void operator delete(void* p) noexcept
+{
+    if(p != nullptr)
+    {
+        void* block = static_cast<char*>(p) - HEADER_SIZE;
+        allocatedBytes -= *static_cast<std::size_t*>(block);
+        std::free(block);
+    }
+}
+
+
+void operator delete(void* p, std::size_t) noexcept
+{
+    operator delete(p);
+}
+
+
+// Over-aligned allocations (such as a BloomFilterSet's blocks) keep the
+// size just before the returned pointer, which is one alignment past the
+// start of the block.
+void* operator new(std::size_t size, std::align_val_t alignment)
+{
+    std::size_t align = std::max(static_cast<std::size_t>(alignment), HEADER_SIZE);
+    void* block = std::aligned_alloc(align, (size + 2 * align - 1) / align * align);
+    if(block == nullptr)
+    {
+        throw std::bad_alloc{};
+    }
+    char* p = static_cast<char*>(block) + align;
+    *reinterpret_cast<std::size_t*>(p - sizeof(std::size_t)) = size;
+    allocatedBytes += size;
+    allocationCount.fetch_add(1, std::memory_order_relaxed);
+    return p;
+}
+
+
+void operator delete(void* p, std::align_val_t alignment) noexcept
+{
+    if(p != nullptr)
+    {
+        std::size_t align = std::max(static_cast<std::size_t>(alignment), HEADER_SIZE);
+        char* q = static_cast<char*>(p);
+        allocatedBytes -= *reinterpret_cast<std::size_t*>(q - sizeof(std::size_t));
+        std::free(q - align);
+    }
+}
+
+
+void operator delete(void* p, std::size_t, std::align_val_t alignment) noexcept
+{
+    operator delete(p, alignment);
+}
+
+
+
+namespace
+{
+    using Clock = std::chrono::steady_clock;
+
+
+    struct Options
+    {
+        std::string wordList;
+        std::size_t words = SIZE_MAX;
+        std::size_t queries = 100000;
+        std::size_t suggestions = 300;
+        unsigned int seed = 1;
+        std::vector<std::string> sets = {"hash", "hash-function", "flat", "avl", "avl-unbalanced", "skiplist", "trie",
+                                          "bloom"};
+        std::vector<std::string> engines;
+    };
+
+
+    // A Backend names a kind of Set and knows how to make an empty one,
+    // given the number of words that will be added to it.
+    struct Backend
+    {
+        std::string key;
+        std::string name;
+        std::function<std::unique_ptr<Set<std::string>>(std::size_t)> make;
+    };
+
+
+    // A BloomFilterSet needs a backing Set that outlives it, so this one
+    // owns its HashSet, as a base class, which is constructed first.
+    struct BloomFilterBacking
+    {
+        HashSet<std::string> hashSet;
+    };
+
+
+    class HashBloomFilterSet : private BloomFilterBacking, public BloomFilterSet
+    {
+    public:
+        explicit HashBloomFilterSet(std::size_t expectedElements)
+            : BloomFilterSet{hashSet, expectedElements}
+        {
+        }
+    };
+
+
+    std::vector<Backend> allBackends()
+    {
+        return {
+            {"hash", "HashSet", [](std::size_t)
+                {
+                    return std::make_unique<HashSet<std::string>>();
+                }},
+            {"hash-function", "HashSet (std::hash through std::function)", [](std::size_t)
+                {
+                    return std::make_unique<HashSet<std::string>>(
+                        [](const std::string& s) { return unsigned(std::hash<std::string>{}(s)); });
+                }},
+            {"flat", "FlatHashSet", [](std::size_t)
+                {
+                    return std::make_unique<FlatHashSet<std::string>>(
+                        [](const std::string& s) { return unsigned(std::hash<std::string>{}(s)); });
+                }},
+            {"avl", "AVLSet (balanced)", [](std::size_t) { return std::make_unique<AVLSet<std::string>>(true); }},
+            {"avl-unbalanced", "AVLSet (unbalanced)", [](std::size_t)
+                {
+                    return std::make_unique<AVLSet<std::string>>(false);
+                }},
+            {"skiplist", "SkipListSet", [](std::size_t) { return std::make_unique<SkipListSet<std::string>>(); }},
+            {"trie", "TrieSet", [](std::size_t) { return std::make_unique<TrieSet>(); }},
+            {"bloom", "BloomFilterSet (over HashSet)", [](std::size_t expected)
+                {
+                    return std::make_unique<HashBloomFilterSet>(expected);
+                }}
+        };
+    }
+
+
+    // The misspellings whose suggestions are timed, by length.
+    struct SuggestionQueries
+    {
+        const char* name;
+        std::vector<std::string> words;
+    };
+
+
+    struct Queries
+    {
+        std::vector<std::string> hits;
+        std::vector<std::string> misses;
+        std::vector<SuggestionQueries> suggestions;
+    };
+
+
+    std::vector<std::string> splitNames(const std::string& value)
+    {
+        std::vector<std::string> names;
+        std::istringstream in{value};
+        std::string name;
+        while(std::getline(in, name, ','))
+        {
+            names.push_back(name);
+        }
+        return names;
+    }
+
+
+    bool parseOptions(int argc, char** argv, Options& options)
+    {
+        if(argc < 2)
+        {
+            return false;
+        }
+        options.wordList = argv[1];
+        for(int i = 2; i < argc; i += 2)
+        {
+            if(i + 1 >= argc)
+            {
+                return false;
+            }
+            std::string value = argv[i + 1];
+            if(std::strcmp(argv[i], "--words") == 0)
+            {
+                // Queries are drawn from the words, so there must be some.
+                options.words = std::stoul(value);
+                if(options.words == 0)
+                {
+                    return false;
+                }
+            }
+            else if(std::strcmp(argv[i], "--queries") == 0)
+            {
+                options.queries = std::stoul(value);
+            }
+            else if(std::strcmp(argv[i], "--suggestions") == 0)
+            {
+                options.suggestions = std::stoul(value);
+            }
+            else if(std::strcmp(argv[i], "--seed") == 0)
+            {
+                options.seed = std::stoul(value);
+            }
+            else if(std::strcmp(argv[i], "--sets") == 0)
+            {
+                options.sets = splitNames(value);
+            }
+            else if(std::strcmp(argv[i], "--engines") == 0)
+            {
+                options.engines = splitNames(value);
+            }
+            else
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+
+    bool loadWords(const std::string& path, std::vector<std::string>& words)
+    {
+        std::ifstream in{path};
+        if(!in)
+        {
+            return false;
+        }
+        std::unordered_set<std::string> seen;
+        std::string line;
+        while(std::getline(in, line))
+        {
+            for(char& c : line)
+            {
+                if(c >= 'a' && c <= 'z')
+                {
+                    c = c - 'a' + 'A';
+                }
+            }
+            if(!line.empty() && line.back() == '\r')
+            {
+                line.pop_back();
+            }
+            if(!line.empty() && seen.insert(line).second)
+            {
+                words.push_back(line);
+            }
+        }
+        return true;
+    }
+
+
+    // misspell() makes one random edit (a deletion, insertion, replacement
+    // or swap) to a copy of the given word, as a typist might.
+    std::string misspell(std::string word, std::mt19937& random)
+    {
+        std::size_t p = random() % word.length();
+        switch(random() % 4)
+        {
+        case 0:
+            if(word.length() > 1)
+            {
+                word.erase(p, 1);
+                break;
+            }
+            [[fallthrough]];
+        case 1:
+            word.insert(p, 1, char('A' + random() % 26));
+            break;
+        case 2:
+            word[p] = char('A' + random() % 26);
+            break;
+        default:
+            if(p + 1 < word.length())
+            {
+                std::swap(word[p], word[p + 1]);
+            }
+            else
+            {
+                word.push_back(char('A' + random() % 26));
+            }
+            break;
+        }
+        return word;
+    }
+
+
+    Queries makeQueries(const std::vector<std::string>& words, const Options& options, std::mt19937& random)
+    {
+        std::unordered_set<std::string> dictionary{words.begin(), words.end()};
+        Queries queries;
+        queries.suggestions = {{"short", {}}, {"medium", {}}, {"long", {}}};
+
+        for(std::size_t i = 0; i < options.queries; i++)
+        {
+            queries.hits.push_back(words[random() % words.size()]);
+        }
+
+        // Misses and misspellings are drawn until there are enough of them,
+        // giving up eventually if the word list can't supply them.
+        for(std::size_t attempts = 0; queries.misses.size() < options.queries && attempts < options.queries * 10;
+            attempts++)
+        {
+            std::string miss = misspell(words[random() % words.size()], random);
+            if(dictionary.count(miss) == 0)
+            {
+                queries.misses.push_back(miss);
+            }
+        }
+
+        for(std::size_t attempts = 0; attempts < options.suggestions * 1000; attempts++)
+        {
+            std::string miss = misspell(words[random() % words.size()], random);
+            std::size_t group = miss.length() <= 5 ? 0 : miss.length() <= 10 ? 1 : 2;
+            if(queries.suggestions[group].words.size() < options.suggestions && dictionary.count(miss) == 0)
+            {
+                queries.suggestions[group].words.push_back(miss);
+            }
+            if(std::all_of(queries.suggestions.begin(), queries.suggestions.end(),
+                           [&](const SuggestionQueries& q) { return q.words.size() >= options.suggestions; }))
+            {
+                break;
+            }
+        }
+        return queries;
+    }
+
+
+    double percentile(std::vector<double>& samples, double p)
+    {
+        if(samples.empty())
+        {
+            return 0.0;
+        }
+        std::size_t k = std::min(samples.size() - 1, std::size_t(p * samples.size()));
+        std::nth_element(samples.begin(), samples.begin() + k, samples.end());
+        return samples[k];
+    }
+
+
+    // timeContains() returns the median and 99th percentile latencies of
+    // contains(), in nanoseconds, over the given words.
+    std::pair<double, double> timeContains(const Set<std::string>& set, const std::vector<std::string>& words)
+    {
+        std::vector<double> samples;
+        samples.reserve(words.size());
+        std::size_t found = 0;
+        for(const std::string& word : words)
+        {
+            auto start = Clock::now();
+            found += set.contains(word);
+            samples.push_back(std::chrono::duration<double, std::nano>(Clock::now() - start).count());
+        }
+        // Using the result keeps the calls from being optimized away.
+        if(found > words.size())
+        {
+            std::cerr << found << std::endl;
+        }
+        double p50 = percentile(samples, 0.50);
+        double p99 = percentile(samples, 0.99);
+        return {p50, p99};
+    }
+
+
+    std::string jsonString(const std::string& s)
+    {
+        std::string out = "\"";
+        for(char c : s)
+        {
+            if(c == '"' || c == '\\')
+            {
+                out += '\\';
+                out += c;
+            }
+            else if(static_cast<unsigned char>(c) < 0x20)
+            {
+                char escape[8];
+                std::snprintf(escape, sizeof(escape), "\\u%04x", c);
+                out += escape;
+            }
+            else
+            {
+                out += c;
+            }
+        }
+        return out + "\"";
+    }
+
+
+    void measure(const Backend& backend, const std::vector<std::string>& words, const Queries& queries,
+                 std::ostream& out)
+    {
+        std::cerr << "measuring " << backend.name << "..." << std::endl;
+
+        std::int64_t before = allocatedBytes;
+        auto start = Clock::now();
+        std::unique_ptr<Set<std::string>> set = backend.make(words.size());
+        for(const std::string& word : words)
+        {
+            set->add(word);
+        }
+        double buildSeconds = std::chrono::duration<double>(Clock::now() - start).count();
+        std::int64_t memory = allocatedBytes - before;
+
+        auto hit = timeContains(*set, queries.hits);
+        auto miss = timeContains(*set, queries.misses);
+
+        out << "    {\n"
+            << "      \"name\": " << jsonString(backend.name) << ",\n"
+            << "      \"size\": " << set->size() << ",\n"
+            << "      \"buildSeconds\": " << buildSeconds << ",\n"
+            << "      \"memoryBytes\": " << memory << ",\n"
+            << "      \"containsHit\": {\"p50Nanoseconds\": " << hit.first
+            << ", \"p99Nanoseconds\": " << hit.second << "},\n"
+            << "      \"containsMiss\": {\"p50Nanoseconds\": " << miss.first
+            << ", \"p99Nanoseconds\": " << miss.second << "},\n";
+
+        // Every miss the filter lets through is a false positive.
+        if(auto* bloom = dynamic_cast<const BloomFilterSet*>(set.get()))
+        {
+            std::size_t passed = 0;
+            for(const std::string& word : queries.misses)
+            {
+                passed += bloom->mightContain(word);
+            }
+            out << "      \"falsePositiveRate\": "
+                << (queries.misses.empty() ? 0.0 : double(passed) / queries.misses.size()) << ",\n";
+        }
+
+        out << "      \"findSuggestions\": {";
+
+        WordChecker checker{*set};
+        for(std::size_t g = 0; g < queries.suggestions.size(); g++)
+        {
+            const SuggestionQueries& group = queries.suggestions[g];
+            std::size_t suggestions = 0;
+            std::uint64_t allocationsBefore = allocationCount.load(std::memory_order_relaxed);
+            auto groupStart = Clock::now();
+            for(const std::string& word : group.words)
+            {
+                suggestions += checker.findSuggestions(word).size();
+            }
+            double seconds = std::chrono::duration<double>(Clock::now() - groupStart).count();
+            std::uint64_t allocations = allocationCount.load(std::memory_order_relaxed) - allocationsBefore;
+            double calls = group.words.empty() ? 1.0 : double(group.words.size());
+            out << (g > 0 ? ", " : "") << "\n        " << jsonString(group.name)
+                << ": {\"words\": " << group.words.size()
+                << ", \"suggestions\": " << suggestions
+                << ", \"wordsPerSecond\": " << (seconds > 0 ? group.words.size() / seconds : 0)
+                << ", \"nanosecondsPerCall\": " << seconds * 1e9 / calls
+                << ", \"allocationsPerCall\": " << allocations / calls << "}";
+        }
+        out << "\n      }\n"
+            << "    }";
+    }
+
+
+    // measureEngine() builds an index of the given type on the words and
+    // writes its costs and the latency of its findSuggestions().
+    template <typename Index>
+    void measureEngine(const std::string& name, const std::vector<std::string>& words, const Queries& queries,
+                       std::ostream& out)
+    {
+        std::cerr << "measuring " << name << "..." << std::endl;
+
+        std::int64_t before = allocatedBytes;
+        auto start = Clock::now();
+        std::unique_ptr<Index> index = std::make_unique<Index>();
+        for(const std::string& word : words)
+        {
+            index->add(word);
+        }
+        double buildSeconds = std::chrono::duration<double>(Clock::now() - start).count();
+        std::int64_t memory = allocatedBytes - before;
+
+        out << "    {\n"
+            << "      \"name\": " << jsonString(name) << ",\n"
+            << "      \"size\": " << index->size() << ",\n"
+            << "      \"buildSeconds\": " << buildSeconds << ",\n"
+            << "      \"memoryBytes\": " << memory << ",\n"
+            << "      \"memoryUsage\": " << index->memoryUsage() << ",\n"
+            << "      \"findSuggestions\": {";
+
+        for(unsigned int distance = 1; distance <= 2; distance++)
+        {
+            std::vector<double> samples;
+            std::size_t suggestions = 0;
+            for(const SuggestionQueries& group : queries.suggestions)
+            {
+                for(const std::string& word : group.words)
+                {
+                    auto callStart = Clock::now();
+                    suggestions += index->findSuggestions(word, distance).size();
+                    samples.push_back(std::chrono::duration<double, std::micro>(Clock::now() - callStart).count());
+                }
+            }
+            std::size_t count = samples.size();
+            double p50 = percentile(samples, 0.50);
+            double p99 = percentile(samples, 0.99);
+            out << (distance > 1 ? ", " : "") << "\n        \"distance" << distance << "\": {"
+                << "\"words\": " << count
+                << ", \"suggestions\": " << suggestions
+                << ", \"p50Microseconds\": " << p50
+                << ", \"p99Microseconds\": " << p99 << "}";
+        }
+        out << "\n      }\n"
+            << "    }";
+    }
+
+
+    // An Engine names an index measured by measureEngine().
+    struct Engine
+    {
+        std::string key;
+        std::string name;
+        std::function<void(const std::vector<std::string>&, const Queries&, std::ostream&)> measure;
+    };
+
+
+    std::vector<Engine> allEngines()
+    {
+        return {
+            {"deletions", "DeletionIndex (distance 2)",
+                [](const std::vector<std::string>& words, const Queries& queries, std::ostream& out)
+                {
+                    measureEngine<DeletionIndex>("DeletionIndex (distance 2)", words, queries, out);
+                }},
+            {"length-buckets", "LengthBucketIndex",
+                [](const std::vector<std::string>& words, const Queries& queries, std::ostream& out)
+                {
+                    measureEngine<LengthBucketIndex>("LengthBucketIndex", words, queries, out);
+                }}
+        };
+    }
+}
+
+
+int main(int argc, char** argv)
+{
+    Options options;
+    if(!parseOptions(argc, argv, options))
+    {
+        std::cerr << "usage: " << argv[0] << " WORDLIST [--words N] [--queries N] [--suggestions N]"
+                  << " [--seed N] [--sets NAME,NAME,...] [--engines NAME,NAME,...]" << std::endl;
+        return 2;
+    }
+
+    std::vector<std::string> words;
+    if(!loadWords(options.wordList, words) || words.empty())
+    {
+        std::cerr << "cannot read words from " << options.wordList << std::endl;
+        return 1;
+    }
+
+    std::mt19937 random{options.seed};
+    std::shuffle(words.begin(), words.end(), random);
+    words.resize(std::min(words.size(), options.words));
+    Queries queries = makeQueries(words, options, random);
+
+    std::vector<Backend> backends;
+    for(const std::string& key : options.sets)
+    {
+        std::vector<Backend> all = allBackends();
+        auto found = std::find_if(all.begin(), all.end(), [&](const Backend& b) { return b.key == key; });
+        if(found == all.end())
+        {
+            std::cerr << "unknown set " << key << std::endl;
+            return 2;
+        }
+        backends.push_back(*found);
+    }
+
+    std::vector<Engine> engines;
+    for(const std::string& key : options.engines)
+    {
+        std::vector<Engine> all = allEngines();
+        auto found = std::find_if(all.begin(), all.end(), [&](const Engine& e) { return e.key == key; });
+        if(found == all.end())
+        {
+            std::cerr << "unknown engine " << key << std::endl;
+            return 2;
+        }
+        engines.push_back(*found);
+    }
+
+    char date[32];
+    std::time_t now = std::time(nullptr);
+    std::strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%SZ", std::gmtime(&now));
+
+    std::cout << "{\n"
+              << "  \"date\": " << jsonString(date) << ",\n"
+#if defined(__VERSION__)
+              << "  \"compiler\": " << jsonString(__VERSION__) << ",\n"
+#endif
+              << "  \"wordList\": " << jsonString(options.wordList) << ",\n"
+              << "  \"words\": " << words.size() << ",\n"
+              << "  \"seed\": " << options.seed << ",\n"
+              << "  \"sets\": [\n";
+    for(std::size_t i = 0; i < backends.size(); i++)
+    {
+        measure(backends[i], words, queries, std::cout);
+        std::cout << (i + 1 < backends.size() ? ",\n" : "\n");
+    }
+    std::cout << "  ],\n"
+              << "  \"engines\": [\n";
+    for(std::size_t i = 0; i < engines.size(); i++)
+    {
+        engines[i].measure(words, queries, std::cout);
+        std::cout << (i + 1 < engines.size() ? ",\n" : "\n");
+    }
+    std::cout << "  ]\n"
+              << "}" << std::endl;
+    return 0;
+}
@@ -0,0 +1,114 @@
+// spellcheck.cpp
+//
+// A command-line program that checks the spelling of a file of any size:
+//
+//     spellcheck DICTIONARY FILE [--suggest]
+//
+// DICTIONARY is a file of words, one per line.  Each misspelled word in
+// FILE is written to the standard output as a line of tab-separated
+// fields: its byte offset, line, column, and the word itself (uppercased),
+// followed by a comma-separated list of suggestions if --suggest is given.
+// A summary, including the throughput in MB/s, goes to the standard error.
+
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <system_error>
+#include "DocumentChecker.hpp"
+#include "HashSet.hpp"
+#include "WordChecker.hpp"
+
+
+
+namespace
+{
+    bool loadDictionary(const std::string& path, Set<std::string>& words)
+    {
+        std::ifstream in{path};
+        if(!in)
+        {
+            return false;
+        }
+        std::string line;
+        while(std::getline(in, line))
+        {
+            for(char& c : line)
+            {
+                if(c >= 'a' && c <= 'z')
+                {
+                    c = c - 'a' + 'A';
+                }
+            }
+            if(!line.empty() && line.back() == '\r')
+            {
+                line.pop_back();
+            }
+            if(!line.empty())
+            {
+                words.add(line);
+            }
+        }
+        return true;
+    }
+}
+
+
+int main(int argc, char** argv)
+{
+    if(argc < 3 || (argc == 4 && std::strcmp(argv[3], "--suggest") != 0) || argc > 4)
+    {
+        std::cerr << "usage: " << argv[0] << " DICTIONARY FILE [--suggest]" << std::endl;
+        return 2;
+    }
+    bool suggest = argc == 4;
+
+    HashSet<std::string> words;
+    if(!loadDictionary(argv[1], words))
+    {
+        std::cerr << "cannot read dictionary " << argv[1] << std::endl;
+        return 1;
+    }
+
+    WordChecker checker{words};
+    DocumentChecker document{checker};
+    std::ios::sync_with_stdio(false);
+
+    std::uint64_t misspellings = 0;
+    auto report = [&](const DocumentChecker::Misspelling& m)
+    {
+        misspellings++;
+        std::cout << m.offset << '\t' << m.line << '\t' << m.column << '\t' << m.word;
+        if(suggest)
+        {
+            std::cout << '\t';
+            std::vector<std::string> suggestions = checker.findSuggestions(std::string{m.word});
+            for(std::size_t i = 0; i < suggestions.size(); i++)
+            {
+                std::cout << (i > 0 ? "," : "") << suggestions[i];
+            }
+        }
+        std::cout << '\n';
+    };
+
+    auto start = std::chrono::steady_clock::now();
+    std::uint64_t wordsChecked = 0;
+    try
+    {
+        wordsChecked = document.checkFile(argv[2], report);
+    }
+    catch(const std::system_error& e)
+    {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+    std::cout.flush();
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::ifstream in{argv[2], std::ios::binary | std::ios::ate};
+    double megabytes = double(in.tellg()) / 1e6;
+    std::cerr << "checked " << wordsChecked << " words (" << megabytes << " MB) in " << seconds << " s, "
+              << (seconds > 0 ? megabytes / seconds : 0) << " MB/s, " << misspellings << " misspelled" << std::endl;
+    return 0;
+}
@@ -0,0 +1,101 @@
+// spellclient.cpp
+//
+// A command-line client for spellserver, for trying a server out or
+// scripting against it:
+//
+//     spellclient SOCKET [--suggest] [WORD...]
+//
+// Each WORD (or, if none are given, each line of the standard input) is
+// uppercased and sent to the server listening at SOCKET, all in one
+// batch.  For each, a line is written to the standard output: the word,
+// a tab, and "correct" or "misspelled", followed by another tab and a
+// comma-separated list of suggestions for a misspelled word if --suggest
+// is given.
+
+#include <cstring>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "SpellClient.hpp"
+
+
+
+int main(int argc, char** argv)
+{
+    bool suggest = argc >= 3 && std::strcmp(argv[2], "--suggest") == 0;
+    if(argc < 2)
+    {
+        std::cerr << "usage: " << argv[0] << " SOCKET [--suggest] [WORD...]" << std::endl;
+        return 2;
+    }
+
+    std::vector<std::string> words;
+    for(int i = suggest ? 3 : 2; i < argc; i++)
+    {
+        words.emplace_back(argv[i]);
+    }
+    if(words.empty())
+    {
+        std::string line;
+        while(std::getline(std::cin, line))
+        {
+            if(!line.empty() && line.back() == '\r')
+            {
+                line.pop_back();
+            }
+            if(!line.empty())
+            {
+                words.push_back(line);
+            }
+        }
+    }
+    for(std::string& word : words)
+    {
+        for(char& c : word)
+        {
+            if(c >= 'a' && c <= 'z')
+            {
+                c = c - 'a' + 'A';
+            }
+        }
+    }
+
+    try
+    {
+        SpellClient client{argv[1]};
+        std::vector<bool> exists = client.wordsExist(words);
+
+        std::vector<std::string> misspellings;
+        for(std::size_t i = 0; i < words.size(); i++)
+        {
+            if(suggest && !exists[i])
+            {
+                misspellings.push_back(words[i]);
+            }
+        }
+        std::vector<std::vector<std::string>> suggestions = client.findSuggestions(misspellings);
+
+        std::size_t m = 0;
+        for(std::size_t i = 0; i < words.size(); i++)
+        {
+            std::cout << words[i] << '\t' << (exists[i] ? "correct" : "misspelled");
+            if(suggest && !exists[i])
+            {
+                std::cout << '\t';
+                for(std::size_t s = 0; s < suggestions[m].size(); s++)
+                {
+                    std::cout << (s > 0 ? "," : "") << suggestions[m][s];
+                }
+                m++;
+            }
+            std::cout << '\n';
+        }
+    }
+    catch(const std::exception& e)
+    {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
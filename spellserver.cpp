@@ -0,0 +1,141 @@
+// spellserver.cpp
+//
+// A daemon that loads a dictionary once and answers spelling requests
+// from any number of local clients (see SpellServer.hpp and
+// SpellProtocol.hpp):
+//
+//     spellserver DICTIONARY SOCKET [--threads N] [--batch N] [--delay MICROSECONDS]
+//
+// DICTIONARY is a file of words, one per line, which are uppercased (as
+// spellcheck does).  The server listens on a Unix domain socket at SOCKET
+// until it receives SIGINT or SIGTERM.  --threads sets the number of
+// worker threads, and --batch and --delay bound the size of a batch and
+// how long its first request waits for others to join it.
+
+#include <chrono>
+#include <csignal>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <system_error>
+#include "HashSet.hpp"
+#include "SpellServer.hpp"
+#include "WordChecker.hpp"
+
+
+
+namespace
+{
+    SpellServer* runningServer = nullptr;
+
+
+    void stopServer(int)
+    {
+        if(runningServer != nullptr)
+        {
+            runningServer->stop();
+        }
+    }
+
+
+    bool loadDictionary(const std::string& path, Set<std::string>& words)
+    {
+        std::ifstream in{path};
+        if(!in)
+        {
+            return false;
+        }
+        std::string line;
+        while(std::getline(in, line))
+        {
+            for(char& c : line)
+            {
+                if(c >= 'a' && c <= 'z')
+                {
+                    c = c - 'a' + 'A';
+                }
+            }
+            if(!line.empty() && line.back() == '\r')
+            {
+                line.pop_back();
+            }
+            if(!line.empty())
+            {
+                words.add(line);
+            }
+        }
+        return true;
+    }
+
+
+    bool parseCount(const char* text, unsigned long& count)
+    {
+        char* end;
+        count = std::strtoul(text, &end, 10);
+        return *text != '\0' && *end == '\0';
+    }
+}
+
+
+int main(int argc, char** argv)
+{
+    SpellServer::Options options;
+    bool valid = argc >= 3 && argc % 2 == 1;
+    for(int i = 3; valid && i + 1 < argc; i += 2)
+    {
+        unsigned long value;
+        valid = parseCount(argv[i + 1], value);
+        if(std::strcmp(argv[i], "--threads") == 0)
+        {
+            options.threadCount = value;
+        }
+        else if(std::strcmp(argv[i], "--batch") == 0)
+        {
+            valid = valid && value > 0;
+            options.maxBatchSize = value;
+        }
+        else if(std::strcmp(argv[i], "--delay") == 0)
+        {
+            options.maxBatchDelay = std::chrono::microseconds{value};
+        }
+        else
+        {
+            valid = false;
+        }
+    }
+    if(!valid)
+    {
+        std::cerr << "usage: " << argv[0]
+                  << " DICTIONARY SOCKET [--threads N] [--batch N] [--delay MICROSECONDS]" << std::endl;
+        return 2;
+    }
+
+    HashSet<std::string> words;
+    if(!loadDictionary(argv[1], words))
+    {
+        std::cerr << "cannot read dictionary " << argv[1] << std::endl;
+        return 1;
+    }
+    WordChecker checker{words};
+
+    try
+    {
+        SpellServer server{checker, argv[2], options};
+        runningServer = &server;
+        std::signal(SIGINT, stopServer);
+        std::signal(SIGTERM, stopServer);
+        std::cerr << "serving " << words.size() << " words on " << argv[2] << std::endl;
+        server.run();
+        std::signal(SIGINT, SIG_DFL);
+        std::signal(SIGTERM, SIG_DFL);
+        runningServer = nullptr;
+    }
+    catch(const std::system_error& e)
+    {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}